@@ -0,0 +1,794 @@
+#include "CameraMath.hpp"
+#include "CompactMesh.hpp"
+#include "DataTypes.hpp"
+#include "DebugUI.hpp"
+#include "FilledRenderer.hpp"
+#include "FrameArena.hpp"
+#include "FrameBuffer.hpp"
+#include "FramePacing.hpp"
+#include "InputParser.hpp"
+#include "MeshBuilder.hpp"
+#include "MeshNormals.hpp"
+#include "MeshTopology.hpp"
+#include "ParallelRenderer.hpp"
+#include "RenderMeshComposite.hpp"
+#include "RenderPipeline.hpp"
+#include "Scene.hpp"
+#include "Shading.hpp"
+#include "TransformStage.hpp"
+#include "Validation.hpp"
+#include "VectorBatch.hpp"
+#include "VectorOperations.hpp"
+#include "WireframeRenderer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+    EngineBench.cpp
+
+    Description:
+        Self-contained micro/macro benchmarks for every engine layer, from
+        the vector kernels up to a full composite frame presented to a null
+        sink. Results are printed as JSON on stdout.
+
+    Usage:
+        EngineBench [--quick] [--filter <substring>]
+*/
+
+// Counts heap allocations for frame_loop
+COUNT_GLOBAL_ALLOCATIONS();
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchConfig {
+        double budget_s = 0.25; // sampling time per benchmark
+        size_t min_samples = 20;
+        std::string filter;
+};
+
+struct BenchResult {
+        std::string name;
+        std::string scene;
+        std::string unit;
+        double items_per_call = 0;
+        size_t samples = 0;
+        double throughput = 0; // unit per second
+        double p50_ns = 0, p90_ns = 0, p99_ns = 0, mean_ns = 0;
+        std::string extra; // additional JSON members, already formatted
+};
+
+BenchConfig g_config;
+std::vector<BenchResult> g_results;
+
+// Keeps results observable so the optimizer cannot drop the work
+volatile double g_sink = 0.0;
+
+double Percentile(std::vector<double> &sorted, double p) {
+        if (sorted.empty())
+                return 0.0;
+        const size_t i = std::min(
+            sorted.size() - 1,
+            static_cast<size_t>(p * static_cast<double>(sorted.size())));
+        return sorted[i];
+}
+
+// Times `fn` (which performs `batch` calls of the measured operation per
+// invocation) until the time budget is spent. Latency percentiles are per
+// call; throughput is items_per_call * calls / second.
+// Whether --filter lets `name` run on `scene`
+bool Selected(const std::string &name, const std::string &scene) {
+        return g_config.filter.empty() ||
+               (name + "/" + scene).find(g_config.filter) != std::string::npos;
+}
+
+void Bench(const std::string &name, const std::string &scene,
+           const std::string &unit, double items_per_call, size_t batch,
+           const std::function<void()> &fn, std::string extra = {}) {
+        if (!Selected(name, scene))
+                return;
+
+        fn(); // warm-up
+
+        std::vector<double> samples;
+        samples.reserve(4096);
+        const auto start = Clock::now();
+        double total_ns = 0.0;
+        while (samples.size() < g_config.min_samples ||
+               std::chrono::duration<double>(Clock::now() - start).count() <
+                   g_config.budget_s) {
+                const auto t0 = Clock::now();
+                fn();
+                const auto t1 = Clock::now();
+                const double ns =
+                    std::chrono::duration<double, std::nano>(t1 - t0).count();
+                total_ns += ns;
+                samples.push_back(ns / static_cast<double>(batch));
+        }
+
+        std::sort(samples.begin(), samples.end());
+        BenchResult r;
+        r.name = name;
+        r.scene = scene;
+        r.unit = unit;
+        r.items_per_call = items_per_call;
+        r.samples = samples.size();
+        r.mean_ns = total_ns / static_cast<double>(samples.size() * batch);
+        r.throughput = items_per_call * 1e9 / r.mean_ns;
+        r.p50_ns = Percentile(samples, 0.50);
+        r.p90_ns = Percentile(samples, 0.90);
+        r.p99_ns = Percentile(samples, 0.99);
+        r.extra = std::move(extra);
+        g_results.push_back(std::move(r));
+        std::fprintf(stderr, "  %-32s %-8s %14.0f %s\n", name.c_str(),
+                     scene.c_str(), g_results.back().throughput, unit.c_str());
+}
+
+void PrintJson() {
+        std::printf("{\n  \"benchmarks\": [\n");
+        for (size_t i = 0; i < g_results.size(); ++i) {
+                const BenchResult &r = g_results[i];
+                std::printf("    {\"name\": \"%s\", \"scene\": \"%s\", "
+                            "\"unit\": \"%s\", \"items_per_call\": %.0f, "
+                            "\"samples\": %zu, \"throughput\": %.1f, "
+                            "\"mean_ns\": %.1f, \"p50_ns\": %.1f, "
+                            "\"p90_ns\": %.1f, \"p99_ns\": %.1f%s}%s\n",
+                            r.name.c_str(), r.scene.c_str(), r.unit.c_str(),
+                            r.items_per_call, r.samples, r.throughput,
+                            r.mean_ns, r.p50_ns, r.p90_ns, r.p99_ns,
+                            r.extra.c_str(),
+                            i + 1 < g_results.size() ? "," : "");
+        }
+        std::printf("  ]\n}\n");
+}
+
+struct Scene {
+        std::string name;
+        size_t rings, segments;
+};
+
+size_t CountCells(const Frame &fb, char ch) {
+        size_t n = 0;
+        for (int y = 0; y < fb.height(); ++y)
+                n += static_cast<size_t>(std::count(fb[y], fb[y] + fb.width(), ch));
+        return n;
+}
+
+// ─────────────────────────────────────────────
+// Vector math and camera transforms
+// ─────────────────────────────────────────────
+
+void BenchVectorMath(const Scene &scene, const Vec3Buffer &verts) {
+        const double n = static_cast<double>(verts.size());
+        Vec3Buffer other = verts, out;
+        std::vector<double> dots;
+        out.resize(verts.size());
+        dots.resize(verts.size());
+
+        Bench("vec_add_atomic_loop", scene.name, "verts/s", n, 1, [&] {
+                for (size_t i = 0; i < verts.size(); ++i) {
+                        Vec3_t r = VecAddAtomic(
+                            {verts.x()[i], verts.y()[i], verts.z()[i]},
+                            {other.x()[i], other.y()[i], other.z()[i]});
+                        out.x()[i] = r.x;
+                        out.y()[i] = r.y;
+                        out.z()[i] = r.z;
+                }
+        });
+        Bench("vec_add_batch", scene.name, "verts/s", n, 1,
+              [&] { VecAddBatch(verts, other, out); });
+        Bench("vec_scale_batch", scene.name, "verts/s", n, 1,
+              [&] { VecScaleBatch(verts, 0.5, out); });
+        Bench("vec_dot_batch", scene.name, "verts/s", n, 1,
+              [&] { VecDotBatch(verts, other, dots); });
+        Bench("vec_cross_batch", scene.name, "verts/s", n, 1,
+              [&] { VecCrossBatch(verts, other, out); });
+        Bench("vec_normalize_batch", scene.name, "verts/s", n, 1,
+              [&] { VecNormalizeBatch(verts, out); });
+        Bench("vec_lerp_batch", scene.name, "verts/s", n, 1,
+              [&] { VecLerpBatch(verts, other, 0.25, out); });
+        Bench("validate_vertices", scene.name, "verts/s", n, 1,
+              [&] { g_sink = g_sink + FindInvalidVertex(verts); });
+        g_sink = g_sink + out.x()[0] + dots[0];
+}
+
+void BenchCamera(const Scene &scene, const Vec3Buffer &verts) {
+        const double n = static_cast<double>(verts.size());
+        const Vec3_t eye = {3.0, 2.0, 6.0};
+        const Vec3_t target = {0.0, 0.0, 0.0};
+        const double focal =
+            CameraSettings::FovToFocalLength(CameraSettings::camera_fov);
+
+        Bench("look_at", scene.name, "calls/s", 1, 1000, [&] {
+                for (int i = 0; i < 1000 && Selected("frame_loop", scene.name); ++i) {
+                        CameraView_t v = LookAt(eye, target, CAMERA_UP);
+                        g_sink = g_sink + v.right.x;
+                }
+        });
+
+        CameraView_t view = LookAt(eye, target, CAMERA_UP);
+        Vec3Buffer cam;
+        Vec2Buffer proj;
+        cam.reserve(verts.size());
+        proj.reserve(verts.size());
+        Bench("world_to_camera_project", scene.name, "verts/s", n, 1, [&] {
+                cam.clear();
+                proj.clear();
+                for (size_t i = 0; i < verts.size(); ++i) {
+                        WorldToCamera(verts, i, view, eye, cam);
+                        if (cam.z()[i] > 0.0)
+                                ProjectToScreen(cam, i, focal,
+                                                CameraSettings::aspect_ratio,
+                                                proj);
+                        else
+                                proj.push_back(0.0, 0.0);
+                }
+        });
+
+        TransformedVertices xf;
+        Bench("transform_vertices", scene.name, "verts/s", n, 1,
+              [&] { TransformVertices(verts, eye, target, xf); });
+        const Vec3BufferF32 verts_f32 = Vec3BufferF32::From(verts);
+        Bench("transform_vertices_f32", scene.name, "verts/s", n, 1,
+              [&] { TransformVertices(verts_f32, eye, target, xf); });
+        const QuantizedVec3Buffer verts_q16 =
+            QuantizedVec3Buffer::Quantize(verts);
+        Bench("transform_vertices_q16", scene.name, "verts/s", n, 1,
+              [&] { TransformVertices(verts_q16, eye, target, xf); });
+        // Either side may be empty when --filter skipped its benchmarks
+        if (proj.size() > 0)
+                g_sink = g_sink + proj.x()[0];
+        if (xf.size() > 0)
+                g_sink = g_sink + xf.proj.x()[0];
+}
+
+// ─────────────────────────────────────────────
+// Rasterization
+// ─────────────────────────────────────────────
+
+// A depth clear plus a small and a large triangle per call, in one depth
+// storage format: what a sparse frame costs on the depth side
+template <typename Format>
+void BenchDepthFormat(const char *name) {
+        const int w = CameraSettings::screen_width;
+        const int h = CameraSettings::screen_height;
+        Frame fb(w, h);
+        DepthSurface<Format> zbuf(w, h);
+        Bench(std::string("depth_clear_draw_") + name, "212x49", "frames/s", 1, 1, [&] {
+                FrameIO::ClearZBuffer(zbuf);
+                DrawFilledTriangle(Vec2_t{100.2, 20.1}, Vec2_t{106.7, 21.4},
+                                   Vec2_t{102.3, 25.8}, 2.0, 2.0, 2.0, fb, zbuf, '#');
+                DrawFilledTriangle(Vec2_t{2.5, 1.5}, Vec2_t{208.0, 6.0},
+                                   Vec2_t{90.0, 47.5}, 3.0, 4.0, 5.0, fb, zbuf, '#');
+        }, ", \"bytes_per_pixel\": " + std::to_string(sizeof(typename Format::storage)));
+}
+
+void BenchRaster() {
+        const int w = CameraSettings::screen_width;
+        const int h = CameraSettings::screen_height;
+        Frame fb(w, h);
+        DepthBuffer zbuf(w, h);
+
+        struct Tri {
+                const char *name;
+                Vec2_t a, b, c;
+        };
+        const Tri tris[] = {
+            {"small", {100.2, 20.1}, {106.7, 21.4}, {102.3, 25.8}},
+            {"large", {2.5, 1.5}, {208.0, 6.0}, {90.0, 47.5}},
+            {"sliver", {1.0, 2.0}, {210.0, 46.0}, {211.0, 47.0}},
+        };
+
+        for (const Tri &t : tris) {
+                FrameIO::ClearFramebuffer(fb);
+                FrameIO::ClearZBuffer(zbuf);
+                DrawFilledTriangle(t.a, t.b, t.c, 1.0, 1.0, 1.0, fb, zbuf, '#');
+                const double pixels = static_cast<double>(CountCells(fb, '#'));
+
+                // Depth decreases every call so each one really writes
+                FrameIO::ClearZBuffer(zbuf);
+                double z = CameraSettings::far_plane * 0.5;
+                Bench(std::string("draw_filled_triangle_") + t.name, "212x49",
+                      "pixels/s", pixels, 1, [&] {
+                              z *= 0.999999;
+                              DrawFilledTriangle(t.a, t.b, t.c, z, z, z, fb,
+                                                 zbuf, '#');
+                      },
+                      ", \"pixels_per_triangle\": " +
+                          std::to_string(static_cast<size_t>(pixels)));
+        }
+
+        // A large triangle hidden behind one already drawn: rejected by the
+        // depth pyramid without touching any pixels
+        {
+                const Tri &t = tris[1];
+                FrameIO::ClearFramebuffer(fb);
+                FrameIO::ClearZBuffer(zbuf);
+                DrawFilledTriangle(t.a, t.b, t.c, 1.0, 1.0, 1.0, fb, zbuf, '#');
+                const double pixels = static_cast<double>(CountCells(fb, '#'));
+                Bench("draw_filled_triangle_occluded", "212x49", "pixels/s",
+                      pixels, 1, [&] {
+                              DrawFilledTriangle(t.a, t.b, t.c, 2.0, 2.0, 2.0,
+                                                 fb, zbuf, '+');
+                      });
+        }
+
+        struct Line {
+                const char *name;
+                Int2_t a, b;
+        };
+        const Line lines[] = {
+            {"short", {100, 20}, {108, 24}},
+            {"long", {0, 0}, {211, 48}},
+            {"offscreen", {-4000, -900}, {4200, 1000}},
+        };
+        for (const Line &l : lines) {
+                FrameIO::ClearFramebuffer(fb);
+                DrawLine(l.a, l.b, fb, '*');
+                const double pixels = static_cast<double>(CountCells(fb, '*'));
+                Bench(std::string("draw_line_") + l.name, "212x49", "pixels/s",
+                      std::max(pixels, 1.0), 100, [&] {
+                              for (int i = 0; i < 100; ++i)
+                                      DrawLine(l.a, l.b, fb, '*');
+                      });
+        }
+}
+
+// ─────────────────────────────────────────────
+// Topology, full frames and presentation
+// ─────────────────────────────────────────────
+
+void BenchTopology(const Scene &scene, const TriangleBuffer &tris) {
+        const double n = static_cast<double>(tris.size());
+        Bench("extract_edges", scene.name, "tris/s", n, 1, [&] {
+                auto edges = ExtractEdges(tris);
+                g_sink = g_sink + static_cast<double>(edges.size());
+        });
+        FrameArena arena;
+        Bench("extract_edges_arena", scene.name, "tris/s", n, 1, [&] {
+                arena.Reset();
+                auto edges = ExtractEdges(tris, arena.resource());
+                g_sink = g_sink + static_cast<double>(edges.size());
+        });
+        MeshTopology topo;
+        TriangleBuffer copy = tris;
+        Bench("mesh_topology_build", scene.name, "tris/s", n, 1, [&] {
+                copy.touch();
+                topo.Update(copy);
+        });
+        Bench("mesh_topology_cached", scene.name, "calls/s", 1, 1,
+              [&] { topo.Update(copy); });
+}
+
+// Normal cache rebuild, and the per-frame work shading adds on top of it
+void BenchShading(const Scene &scene, const Vec3Buffer &verts,
+                  const TriangleBuffer &tris) {
+        const double n = static_cast<double>(tris.size());
+        MeshNormals normals;
+        Vec3Buffer copy = verts;
+        Bench("mesh_normals_build", scene.name, "tris/s", n, 1, [&] {
+                copy.touch();
+                normals.Update(copy, tris);
+        });
+
+        std::vector<uint8_t> mask(tris.size());
+        int frame = 0;
+        Bench("facing_mask", scene.name, "tris/s", n, 1, [&] {
+                const double angle = 0.05 * frame++;
+                FacingMask(normals, {std::sin(angle) * 6.0, 3.0, std::cos(angle) * 6.0},
+                           mask, 0, mask.size(), 0);
+                g_sink = g_sink + mask[0];
+        });
+
+        std::vector<uint8_t> light(verts.size());
+        const Lighting lighting;
+        Bench("light_vertices", scene.name, "verts/s",
+              static_cast<double>(verts.size()), 1, [&] {
+                      LightVertices(normals.vertex, lighting.direction,
+                                    lighting.ambient, light, 0, light.size(), 0);
+                      g_sink = g_sink + light[0];
+              });
+}
+
+// Sanity check before timing anything: a front face lit from the eye
+// must reach full luminance, and the same face wound the other way must be
+// culled. Catches lighting and culling disagreeing on which side is front.
+bool CheckHeadlight() {
+        Vec3Buffer verts;
+        TriangleBuffer tris;
+        BuildTriangleMesh({-1, -1, 0}, {0, 1, 0}, {1, -1, 0}, verts, tris);
+        MeshNormals normals;
+        normals.Update(verts, tris);
+        const Vec3_t eye = {0, 0, 5};
+        std::vector<uint8_t> facing(1), light(3);
+        FacingMask(normals, eye, facing, 0, 1, 0);
+        LightVertices(normals.vertex, {0, 0, 1}, 0.1, light, 0, 3, 0);
+        if (facing[0] == 1 && light[0] == 255)
+                return true;
+        std::fprintf(stderr, "headlight check failed: facing %d, luminance %d "
+                             "(expected 1, 255)\n",
+                     facing[0], light[0]);
+        return false;
+}
+
+void BenchFrames(const Scene &scene, const Vec3Buffer &verts,
+                 const TriangleBuffer &tris) {
+        const int w = CameraSettings::screen_width;
+        const int h = CameraSettings::screen_height;
+        Frame frames[2] = {Frame(w, h), Frame(w, h)};
+        DepthBuffer zbuf(w, h);
+        TransformedVertices xf;
+        MeshTopology topo;
+        int frame = 0;
+
+        auto render = [&](Frame &fb, auto &&composite) {
+                const double angle = 0.05 * frame++;
+                const Vec3_t eye = {std::sin(angle) * 6.0, 3.0,
+                                    std::cos(angle) * 6.0};
+                FrameIO::ClearFramebuffer(fb);
+                FrameIO::ClearZBuffer(zbuf);
+                composite(eye, fb);
+        };
+
+        Bench("composite_frame", scene.name, "frames/s", 1, 1, [&] {
+                render(frames[frame & 1], [&](const Vec3_t &eye, Frame &fb) {
+                        RenderMeshComposite(verts, tris, eye, {0, 0, 0}, xf,
+                                            topo, fb, zbuf, '.', '*');
+                });
+        });
+
+        // Culling from cached face planes, then flat and Gouraud shading
+        MeshNormals normals;
+        normals.Update(verts, tris);
+        MeshShading shading;
+        const GlyphRamp ramp;
+        const Lighting lighting;
+        auto shaded = [&](const char *name, ShadeMode mode) {
+                Bench(name, scene.name, "frames/s", 1, 1, [&] {
+                        render(frames[frame & 1], [&](const Vec3_t &eye,
+                                                      Frame &fb) {
+                                shading.Update(normals, eye,
+                                               mode == ShadeMode::Solid ? nullptr : &lighting,
+                                               xf.light);
+                                FillStyle style('.');
+                                style.mode = mode;
+                                style.ramp = &ramp;
+                                style.facing = shading.facing;
+                                RenderMeshComposite(verts, tris, eye, {0, 0, 0},
+                                                    xf, topo, fb, zbuf, style, '*');
+                        });
+                });
+        };
+        shaded("composite_frame_cached_cull", ShadeMode::Solid);
+        shaded("composite_frame_flat", ShadeMode::Flat);
+        shaded("composite_frame_gouraud", ShadeMode::Gouraud);
+
+        // Each pipeline mode through the runtime switch
+        auto pipeline = [&](const char *name, RenderMode mode, bool outline) {
+                RenderSettings settings;
+                settings.mode = mode;
+                settings.outline = outline;
+                settings.style = FillStyle('.');
+                Bench(name, scene.name, "frames/s", 1, 1, [&] {
+                        render(frames[frame & 1], [&](const Vec3_t &eye,
+                                                      Frame &fb) {
+                                RenderMesh(settings, verts, tris, eye, {0, 0, 0},
+                                           xf, topo, nullptr, fb, zbuf);
+                        });
+                });
+        };
+        pipeline("pipeline_wireframe", RenderMode::Wireframe, false);
+        pipeline("pipeline_filled", RenderMode::Filled, false);
+
+        ParallelRasterizer raster;
+        Bench("composite_frame_parallel", scene.name, "frames/s", 1, 1,
+              [&] {
+                      render(frames[frame & 1], [&](const Vec3_t &eye,
+                                                    Frame &fb) {
+                              RenderMeshComposite(verts, tris, eye, {0, 0, 0},
+                                                  xf, topo, raster, fb, zbuf,
+                                                  '.', '*');
+                      });
+              },
+              ", \"threads\": " + std::to_string(raster.threads()));
+
+        // Diff + encode of consecutive frames against a null sink
+        FrameIO::FramePresenter presenter(-1);
+        uint64_t bytes = 0, presents = 0;
+        Bench("present_diff", scene.name, "frames/s", 1, 1, [&] {
+                const int cur = frame & 1;
+                render(frames[cur], [&](const Vec3_t &eye, Frame &fb) {
+                        RenderMeshComposite(verts, tris, eye, {0, 0, 0}, xf,
+                                            topo, fb, zbuf, '.', '*');
+                });
+                bytes += presenter.Present(frames[cur], frames[cur ^ 1]);
+                ++presents;
+        });
+        Bench("present_full", scene.name, "frames/s", 1, 1,
+              [&] { presenter.PresentFull(frames[0]); },
+              ", \"bytes_per_frame\": " +
+                  std::to_string(presenter.last_bytes()));
+        if (!g_results.empty() && presents > 0 &&
+            g_results.back().name == "present_full")
+                g_results[g_results.size() - 2].extra =
+                    ", \"bytes_per_frame\": " +
+                    std::to_string(bytes / presents);
+
+        // The demo's steady-state loop: frame arena, render, overlay text,
+        // present. Reports the heap allocations it makes per frame, which
+        // must be exactly 0 once warmed up.
+        FrameArena arena;
+        DebugUI::OverlayLines overlay;
+        DebugUI::show_debug = true;
+        auto loop_frame = [&] {
+                arena.Reset();
+                const int cur = frame & 1;
+                render(frames[cur], [&](const Vec3_t &eye, Frame &fb) {
+                        RenderMeshComposite(verts, tris, eye, {0, 0, 0}, xf,
+                                            topo, fb, zbuf, '.', '*');
+                        DebugUI::OverlayLines lines = DebugUI::Lines(
+                            eye, {0, 0, 0}, 60.0, presenter.last_bytes(),
+                            arena.resource());
+                        if (lines != overlay)
+                                overlay = lines;
+                        DebugUI::Draw(fb, overlay);
+                });
+                presenter.Present(frames[cur], frames[cur ^ 1]);
+        };
+        // Warm-up: one full orbit, so the overlay has seen every width of
+        // number it prints, then until a frame neither spills the arena (it
+        // grows at the next Reset) nor touches the heap
+        for (int i = 0; i < 1000; ++i) {
+                const uint64_t before = HeapStats::Allocations();
+                loop_frame();
+                if (i >= 126 && arena.spilled() == 0 &&
+                    HeapStats::Allocations() == before)
+                        break;
+        }
+        // Counted per frame, leaving out what Bench itself allocates
+        uint64_t allocations = 0, loops = 0;
+        Bench("frame_loop", scene.name, "frames/s", 1, 1, [&] {
+                const uint64_t before = HeapStats::Allocations();
+                loop_frame();
+                allocations += HeapStats::Allocations() - before;
+                ++loops;
+        });
+        DebugUI::show_debug = false;
+        if (!g_results.empty() && g_results.back().name == "frame_loop") {
+                g_results.back().extra =
+                    ", \"allocs_per_frame\": " +
+                    (allocations == 0
+                         ? std::string("0")
+                         : std::to_string(static_cast<double>(allocations) /
+                                          static_cast<double>(loops)));
+                if (allocations != 0)
+                        std::fprintf(stderr,
+                                     "frame_loop: %llu heap allocations in "
+                                     "%llu warmed-up frames\n",
+                                     static_cast<unsigned long long>(allocations),
+                                     static_cast<unsigned long long>(loops));
+        }
+}
+
+// A 16 x 16 field of instances of the scene mesh with the camera orbiting
+// inside it, so most instances are frustum culled
+void BenchSceneField(const Scene &scene, const Vec3Buffer &verts,
+                     const TriangleBuffer &tris) {
+        constexpr int N = 16;
+        SceneGraph field;
+        const SceneGraph::MeshId mesh = field.AddMesh(verts, tris);
+        for (int i = 0; i < N; ++i)
+                for (int j = 0; j < N; ++j)
+                        field.AddInstance(
+                            mesh, MakeModelTransform({(i - (N - 1) * 0.5) * 6.0,
+                                                      0.0,
+                                                      (j - (N - 1) * 0.5) * 6.0},
+                                                     0.7 * (i * N + j)));
+
+        const int w = CameraSettings::screen_width;
+        const int h = CameraSettings::screen_height;
+        Frame fb(w, h);
+        DepthBuffer zbuf(w, h);
+        SceneBatch batch;
+        int frame = 0;
+        size_t culled = 0, frames = 0;
+        auto eye = [&] {
+                const double angle = 0.05 * frame++;
+                return Vec3_t{std::sin(angle) * 6.0, 3.0, std::cos(angle) * 6.0};
+        };
+
+        Bench("scene_batch", scene.name, "instances/s", N * N, 1, [&] {
+                BuildSceneBatch(field, eye(), {0, 0, 0}, batch, fb.aspect_ratio());
+                culled += batch.culled;
+                ++frames;
+        });
+        std::string extra = ", \"instances\": " + std::to_string(N * N);
+        if (frames > 0) {
+                extra += ", \"culled_per_frame\": " +
+                         std::to_string(culled / frames);
+                g_results.back().extra = extra;
+        }
+
+        Bench("scene_field_frame", scene.name, "frames/s", 1, 1, [&] {
+                FrameIO::ClearFramebuffer(fb);
+                FrameIO::ClearZBuffer(zbuf);
+                RenderSceneComposite(field, eye(), {0, 0, 0}, batch, fb, zbuf,
+                                     '.', '*');
+        }, extra);
+
+        // A camera low inside the field, where nearer instances hide many
+        // behind them: in any order, then nearest first so the depth pyramid
+        // rejects the hidden ones before they are rasterized
+        auto low_eye = [&] {
+                const double angle = 0.05 * frame++;
+                return Vec3_t{std::sin(angle) * 12.0, 0.5, std::cos(angle) * 12.0};
+        };
+        auto low_field = [&](const char *name, bool front_to_back) {
+                batch.front_to_back = front_to_back;
+                size_t occluded = 0;
+                frames = 0;
+                Bench(name, scene.name, "frames/s", 1, 1, [&] {
+                        FrameIO::ClearFramebuffer(fb);
+                        FrameIO::ClearZBuffer(zbuf);
+                        RenderSceneComposite(field, low_eye(), {0, 0.25, 0}, batch,
+                                             fb, zbuf, '.', '*');
+                        occluded += batch.occluded;
+                        ++frames;
+                });
+                if (frames > 0 && g_results.back().name == name)
+                        g_results.back().extra =
+                            extra + ", \"occluded_per_frame\": " +
+                            std::to_string(static_cast<double>(occluded) /
+                                           static_cast<double>(frames));
+        };
+        low_field("scene_field_frame_low", false);
+        low_field("scene_field_frame_low_front_to_back", true);
+
+        // Fixed camera with one instance in view moving per frame: only the
+        // rectangles it leaves and enters are redrawn. Then nothing moves.
+        batch.front_to_back = false;
+        const Vec3_t still_eye = {0.0, 3.0, 6.0};
+        DamageRegion damage;
+        RenderSceneIncremental(field, still_eye, {0, 0, 0}, batch, nullptr, fb,
+                               zbuf, damage, '.', '*');
+        const uint32_t mover = batch.visible.empty() ? 0 : batch.visible[0];
+        const ModelTransform_t home = field.instance(mover).transform;
+        size_t redrawn = 0;
+        frames = 0;
+        Bench("scene_field_frame_one_moved", scene.name, "frames/s", 1, 1, [&] {
+                ModelTransform_t moved = home;
+                moved.position.y += 0.5 * std::sin(0.1 * frame++);
+                field.SetTransform(mover, moved);
+                RenderSceneIncremental(field, still_eye, {0, 0, 0}, batch,
+                                       nullptr, fb, zbuf, damage, '.', '*');
+                redrawn += damage.area();
+                ++frames;
+        });
+        if (frames > 0)
+                g_results.back().extra =
+                    extra + ", \"pixels_redrawn_per_frame\": " +
+                    std::to_string(redrawn / frames);
+        Bench("scene_field_frame_idle", scene.name, "frames/s", 1, 1, [&] {
+                RenderSceneIncremental(field, still_eye, {0, 0, 0}, batch,
+                                       nullptr, fb, zbuf, damage, '.', '*');
+        }, extra);
+}
+
+// ─────────────────────────────────────────────
+// Input decoding
+// ─────────────────────────────────────────────
+
+// A burst of typing, arrow presses and a mouse drag, decoded as it would be
+// after one bulk read of stdin
+void BenchInput() {
+        std::string burst;
+        for (int i = 0; i < 8; ++i)
+                burst += "wasd\033[A\033[1;5C\033[<0;40;12M\033[<32;41;12M"
+                         "\033[<32;42;13M\033[<0;42;13m\033[<64;40;12M";
+        InputParser parser;
+        size_t events = 0;
+        Bench("input_parse", "burst", "bytes/s",
+              static_cast<double>(burst.size()), 1, [&] {
+                      for (size_t done = 0; done < burst.size();) {
+                              const std::span<char> space = parser.WriteSpace();
+                              const size_t n = std::min(space.size(),
+                                                        burst.size() - done);
+                              std::copy_n(burst.data() + done, n, space.data());
+                              parser.Commit(n);
+                              done += n;
+                              parser.Parse([&](const InputEvent &e) {
+                                      events += e.code != 0;
+                              });
+                      }
+              });
+        g_sink = g_sink + static_cast<double>(events);
+}
+
+// ─────────────────────────────────────────────
+// Frame pacing
+// ─────────────────────────────────────────────
+
+// Cadence of a 500 Hz loop doing ~300 us of work per frame: deadline
+// pacing against the old work-then-sleep_for loop, which drifts by the
+// work time. Latencies are frame to frame.
+void BenchPacing() {
+        FramePacer pacer(500.0);
+        auto work = [] {
+                const int64_t end = FramePacer::Now() + 300'000;
+                while (FramePacer::Now() < end) {
+                }
+        };
+        Bench("frame_pacing_deadline", "500hz", "frames/s", 1, 1, [&] {
+                work();
+                pacer.Wait();
+        });
+        if (!g_results.empty() &&
+            g_results.back().name == "frame_pacing_deadline")
+                g_results.back().extra =
+                    ", \"missed\": " + std::to_string(pacer.missed());
+        Bench("frame_pacing_sleep_for", "500hz", "frames/s", 1, 1, [&] {
+                work();
+                std::this_thread::sleep_for(
+                    std::chrono::nanoseconds(pacer.period_ns()));
+        });
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+        bool quick = false;
+        for (int i = 1; i < argc; ++i) {
+                if (std::strcmp(argv[i], "--quick") == 0)
+                        quick = true;
+                else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+                        g_config.filter = argv[++i];
+        }
+        if (quick) {
+                g_config.budget_s = 0.05;
+                g_config.min_samples = 5;
+        }
+
+        std::vector<Scene> scenes = {
+            {"1k", 16, 32},
+            {"16k", 64, 128},
+            {"200k", 224, 448},
+        };
+        if (quick)
+                scenes.pop_back();
+
+        if (!CheckHeadlight())
+                return 1;
+
+        for (const Scene &scene : scenes) {
+                Vec3Buffer verts;
+                TriangleBuffer tris;
+                BuildSphereMesh({0, 0, 0}, 2.0, scene.rings, scene.segments,
+                                verts, tris);
+                std::fprintf(stderr, "scene %s: %zu verts, %zu tris\n",
+                             scene.name.c_str(), verts.size(), tris.size());
+
+                BenchVectorMath(scene, verts);
+                BenchCamera(scene, verts);
+                BenchTopology(scene, tris);
+                BenchShading(scene, verts, tris);
+                BenchFrames(scene, verts, tris);
+                BenchSceneField(scene, verts, tris);
+        }
+        BenchRaster();
+        BenchInput();
+        BenchPacing();
+        BenchDepthFormat<DepthF64>("f64");
+        BenchDepthFormat<DepthF32>("f32");
+        BenchDepthFormat<DepthUnorm16>("u16");
+
+        PrintJson();
+        return 0;
+}
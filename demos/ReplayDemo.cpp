@@ -0,0 +1,101 @@
+#include "FrameBuffer.hpp"
+#include "FrameRecording.hpp"
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+
+/*
+    ReplayDemo.cpp
+
+    Description:
+        Plays back a recording made with `SpinControlDemo --record FILE`.
+        Frames are decoded straight from the mapped file and presented with
+        the span-diffing presenter, so replay costs no rendering at all.
+
+    Usage:
+        ReplayDemo FILE [--fps N] [--loop]
+
+        Without --fps frames are presented as fast as the terminal takes them.
+*/
+
+// Show the cursor again on exit or signal
+void OnExit() {
+        const char restore[] = "\033[?25h\n";
+        (void)!::write(STDOUT_FILENO, restore, sizeof(restore) - 1);
+}
+
+void SignalHandler(int) { std::exit(0); }
+
+int main(int argc, char **argv) {
+        using Clock = std::chrono::steady_clock;
+
+        if (argc < 2) {
+                std::fprintf(stderr, "usage: %s FILE [--fps N] [--loop]\n",
+                             argv[0]);
+                return 1;
+        }
+
+        double fps = 0.0;
+        bool loop = false;
+        for (int i = 2; i < argc; ++i) {
+                if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+                        fps = std::atof(argv[++i]);
+                else if (std::strcmp(argv[i], "--loop") == 0)
+                        loop = true;
+        }
+
+        FrameIO::FrameReader reader;
+        if (!reader.Open(argv[1])) {
+                std::fprintf(stderr, "%s: not a readable recording\n",
+                             argv[1]);
+                return 1;
+        }
+
+        std::atexit(OnExit);
+        std::signal(SIGINT, SignalHandler);
+        std::signal(SIGTERM, SignalHandler);
+
+        FrameIO::FramePresenter presenter;
+        Frame shown;
+        presenter.ClearScreen();
+
+        const auto frame_time = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(fps > 0.0 ? 1.0 / fps : 0.0));
+        const auto start = Clock::now();
+        auto next = start;
+        uint64_t presented = 0;
+
+        do {
+                reader.Rewind();
+                while (reader.Next()) {
+                        const Frame &frame = reader.frame();
+                        if (presenter.Present(frame, shown) > 0)
+                                FrameIO::CopyBuffer(shown, frame);
+                        ++presented;
+
+                        if (fps > 0.0) {
+                                next += frame_time;
+                                std::this_thread::sleep_until(next);
+                        }
+                }
+                if (reader.index() != reader.frame_count()) {
+                        std::fprintf(stderr, "\n%s: corrupt frame %u\n",
+                                     argv[1], reader.index());
+                        return 1;
+                }
+        } while (loop);
+
+        const double seconds =
+            std::chrono::duration<double>(Clock::now() - start).count();
+        std::fprintf(stderr, "\nReplayed %llu frames in %.3fs (%.0f fps), "
+                     "%llu bytes written\n",
+                     static_cast<unsigned long long>(presented), seconds,
+                     presented / seconds,
+                     static_cast<unsigned long long>(presenter.total_bytes()));
+        return 0;
+}
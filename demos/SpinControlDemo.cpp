@@ -1,36 +1,258 @@
 #include "CameraSettings.hpp"
+#include "AsyncPresenter.hpp"
+#include "CompactMesh.hpp"
 #include "DebugUI.hpp"
+#include "FrameArena.hpp"
 #include "FrameBuffer.hpp"
+#include "FramePacing.hpp"
+#include "FrameProfiler.hpp"
+#include "FrameRecording.hpp"
 #include "KeyMap.hpp"
 #include "MeshBuilder.hpp"
+#include "MeshLoader.hpp"
 #include "RenderMeshComposite.hpp"
 #include "TerminalControl.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <csignal>
 #include <cstdlib>
-#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Heap allocations per frame are shown in the debug overlay (D)
+COUNT_GLOBAL_ALLOCATIONS();
 
 // Ensure terminal is restored on exit or signal
 void OnExit() { Terminal::RestoreTerminal(); }
 
 void SignalHandler(int) { std::exit(0); }
 
-int main() {
+// Camera path around the mesh: the original 6-unit orbit, scaled to the
+// mesh's bounding box so loaded models of any size fill the view. Height
+// and distance are steered with the arrows, mouse drags and the wheel.
+struct Orbit {
+        Vec3_t target = {0, 0, 0};
+        double scale = 1.0;
+        double height = 3.0;
+        double distance = 6.0;
+
+        Vec3_t Eye(double angle) const {
+                return {target.x + std::sin(angle) * distance * scale,
+                        target.y + height * scale,
+                        target.z + std::cos(angle) * distance * scale};
+        }
+
+        void Raise(double amount) {
+                height = std::clamp(height + amount, -12.0, 12.0);
+        }
+
+        void Zoom(int notches) {
+                distance = std::clamp(distance * std::pow(0.9, notches), 2.0,
+                                      30.0);
+        }
+
+        static Orbit Fit(const Vec3Buffer &verts) {
+                Orbit orbit;
+                if (verts.size() == 0)
+                        return orbit;
+                const auto [x0, x1] = std::minmax_element(verts.x().begin(),
+                                                          verts.x().end());
+                const auto [y0, y1] = std::minmax_element(verts.y().begin(),
+                                                          verts.y().end());
+                const auto [z0, z1] = std::minmax_element(verts.z().begin(),
+                                                          verts.z().end());
+                orbit.target = {(*x0 + *x1) * 0.5, (*y0 + *y1) * 0.5,
+                                (*z0 + *z1) * 0.5};
+                const double extent =
+                    std::max({*x1 - *x0, *y1 - *y0, *z1 - *z0});
+                orbit.scale = extent > 0.0 ? extent / 2.0 : 1.0;
+                return orbit;
+        }
+};
+
+// Loads an OBJ (welding duplicate vertices) or a native .tmesh
+bool LoadMeshFile(const std::string &path, Vec3Buffer &verts,
+                  TriangleBuffer &tris) {
+        const bool native = path.size() >= 6 &&
+                            path.compare(path.size() - 6, 6, ".tmesh") == 0;
+        return native ? MeshIO::LoadMesh(path, verts, tris)
+                      : MeshIO::LoadObj(path, verts, tris);
+}
+
+// What the demo draws each frame: the mesh itself, or (--field N) an N x N
+// grid of instances of it through the scene graph. Render() leaves `fb` and
+// `zbuf` alone when nothing they show has changed since the last call, and
+// with a field only redraws where instances moved, so they must be kept
+// between calls; Invalidate() after anything else touches them.
+struct DemoScene {
+        const CompactMesh &mesh;
+        const SceneGraph *field = nullptr;
+        ParallelRasterizer *raster = nullptr;
+        TransformedVertices xform;
+        MeshTopology topology;
+        SceneBatch batch;
+        DamageRegion damage;
+        FillOrder order;
+        bool front_to_back = false;
+        RenderMode mode = RenderMode::Filled;
+        bool outline = true;
+        ShadeMode shade = ShadeMode::Solid;
+        GlyphRamp ramp;
+        Lighting lighting;
+        MeshShading shading;
+
+        bool drawn = false;
+        Vec3_t drawn_eye = {0, 0, 0};
+        int drawn_width = 0;
+        int drawn_height = 0;
+
+        explicit DemoScene(const CompactMesh &m) : mesh(m) {}
+
+        void Invalidate() {
+                drawn = false;
+                batch.drawn.valid = false;
+        }
+
+        // Returns false when `fb` was left as it was
+        bool Render(const Vec3_t &eye, const Vec3_t &target, Frame &fb,
+                    DepthBuffer &zbuf) {
+                const bool lit = shade != ShadeMode::Solid;
+                FillStyle style('.');
+                style.mode = shade;
+                style.ramp = &ramp;
+                if (field) {
+                        batch.front_to_back = front_to_back;
+                        batch.lit = lit;
+                        batch.lighting = lighting;
+                        return RenderSceneIncremental(*field, eye, target,
+                                                      batch, raster, fb, zbuf,
+                                                      damage, style, '*');
+                }
+                // The orbit target is fixed, so the eye and frame size are
+                // the whole camera
+                if (drawn && eye == drawn_eye && fb.width() == drawn_width &&
+                    fb.height() == drawn_height)
+                        return false;
+                drawn = true;
+                drawn_eye = eye;
+                drawn_width = fb.width();
+                drawn_height = fb.height();
+                {
+                        PROFILE_SCOPE(Clear);
+                        FrameIO::ClearFramebuffer(fb);
+                        FrameIO::ClearZBuffer(zbuf);
+                }
+                shading.Update(mesh.normals, eye, lit ? &lighting : nullptr,
+                               xform.light);
+                style.facing = shading.facing;
+                RenderSettings settings;
+                settings.mode = mode;
+                settings.outline = outline;
+                settings.style = style;
+                mesh.Visit([&](const auto &verts, const auto &tris) {
+                        RenderMesh(settings, verts, tris, eye, target, xform,
+                                   topology, raster, fb, zbuf,
+                                   front_to_back ? &order : nullptr);
+                });
+                return true;
+        }
+
+        // M: filled + outline, filled, wireframe (single mesh only)
+        void NextMode() {
+                if (mode == RenderMode::Wireframe) {
+                        mode = RenderMode::Filled;
+                        outline = true;
+                } else if (outline) {
+                        outline = false;
+                } else {
+                        mode = RenderMode::Wireframe;
+                }
+                Invalidate();
+        }
+
+        // L: solid, flat, Gouraud
+        void NextShade() {
+                shade = shade == ShadeMode::Solid  ? ShadeMode::Flat
+                        : shade == ShadeMode::Flat ? ShadeMode::Gouraud
+                                                   : ShadeMode::Solid;
+                Invalidate();
+        }
+};
+
+// Lays out an n x n grid of the mesh around the orbit target, each copy
+// turned a little further about its own center
+void BuildField(SceneGraph &scene, const Vec3Buffer &verts,
+                const TriangleBuffer &tris, const Orbit &orbit, int n) {
+        const SceneGraph::MeshId mesh = scene.AddMesh(verts, tris);
+        const double spacing = 3.0 * orbit.scale;
+        for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                        const double yaw = 0.7 * (i * n + j);
+                        const Vec3_t turned = ApplyModelTransform(
+                            MakeModelTransform({0, 0, 0}, yaw), orbit.target);
+                        const Vec3_t cell = {
+                            orbit.target.x + (i - (n - 1) * 0.5) * spacing,
+                            orbit.target.y,
+                            orbit.target.z + (j - (n - 1) * 0.5) * spacing};
+                        scene.AddInstance(
+                            mesh, MakeModelTransform({cell.x - turned.x,
+                                                      cell.y - turned.y,
+                                                      cell.z - turned.z},
+                                                     yaw));
+                }
+        }
+}
+
+// Renders `frames` frames of the orbit at a fixed 60 Hz step with no terminal
+// attached and records them to `path` (replay with ReplayDemo)
+int RecordHeadless(const std::string &path, int frames, DemoScene &scene,
+                   const Orbit &orbit) {
+        FrameIO::FrameRecorder recorder;
+        if (!recorder.Open(path)) {
+                std::perror(path.c_str());
+                return 1;
+        }
+
+        const Vec3_t target = orbit.target;
+        Frame fb(CameraSettings::screen_width, CameraSettings::screen_height);
+        DepthBuffer zbuf(fb.width(), fb.height());
+
+        for (int f = 0; f < frames; ++f) {
+                const Vec3_t eye = orbit.Eye(f * (0.75 / 60.0));
+
+                Profiler::BeginFrame();
+                scene.Render(eye, target, fb, zbuf);
+                if (!recorder.Append(fb)) {
+                        std::perror(path.c_str());
+                        return 1;
+                }
+                Profiler::EndFrame();
+        }
+
+        const size_t bytes = recorder.bytes_written();
+        if (!recorder.Close()) {
+                std::perror(path.c_str());
+                return 1;
+        }
+        std::fprintf(stderr, "Recorded %d frames (%dx%d) to %s: %zu bytes\n",
+                     frames, fb.width(), fb.height(), path.c_str(), bytes);
+        return 0;
+}
+
+int main(int argc, char **argv) {
         using Clock = std::chrono::steady_clock;
         auto last = Clock::now();
 
-        std::atexit(OnExit);
         std::signal(SIGINT, SignalHandler);
         std::signal(SIGTERM, SignalHandler);
 
-        Vec3_t target = {0, 0, 0};
-
-        char front[CameraSettings::screen_height][CameraSettings::screen_width];
-        char back[CameraSettings::screen_height][CameraSettings::screen_width];
-        double zbuf[CameraSettings::screen_height]
-                   [CameraSettings::screen_width];
+        // Sized to the terminal on the first frame (reported as a resize)
+        DepthBuffer zbuf;
 
         Vec3_t a = {-1, 0, -1};
         Vec3_t b = {1, 0, -1};
@@ -40,36 +262,181 @@ int main() {
         TriangleBuffer tris;
         BuildPyramidMesh(a, b, c, apex, verts, tris);
 
-        double angle = 0.0;
+        // --threads N rasterizes the fill pass on N threads (tile-binned)
+        // --trace FILE writes per-frame stage timings at exit (.json for
+        // Chrome trace format, CSV otherwise)
+        // --record FILE [--frames N] renders headless to a recording
+        // --mesh FILE loads an .obj or .tmesh instead of the pyramid
+        // --save-mesh FILE writes the mesh as .tmesh and exits
+        // --positions f64|f32|q16 selects the in-memory position format
+        // --field N draws an N x N grid of instances of the mesh
+        // --front-to-back fills nearest triangles (or instances) first so
+        // the depth pyramid rejects more of what is behind them
+        // --shade flat|gouraud lights the mesh and draws it with a glyph
+        // ramp, per triangle or interpolated per pixel
+        // --no-mouse leaves the mouse to the terminal (text selection);
+        // otherwise left-drag orbits and the wheel zooms, like the arrows
+        // --fps N paces frames at N Hz (default 60); --tick N runs the
+        // spin simulation at a fixed N Hz (default 120)
+        unsigned threads = 1;
+        double fps = 60.0;
+        double tick = 120.0;
+        int field = 0;
+        PositionFormat format = PositionFormat::Float64;
+        const char *record_path = nullptr;
+        const char *mesh_path = nullptr;
+        const char *save_mesh_path = nullptr;
+        int record_frames = 600;
+        bool front_to_back = false;
+        bool mouse = true;
+        ShadeMode shade = ShadeMode::Solid;
+        for (int i = 1; i < argc; ++i)
+                if (std::strcmp(argv[i], "--front-to-back") == 0)
+                        front_to_back = true;
+                else if (std::strcmp(argv[i], "--no-mouse") == 0)
+                        mouse = false;
+        for (int i = 1; i + 1 < argc; ++i) {
+                if (std::strcmp(argv[i], "--threads") == 0)
+                        threads = static_cast<unsigned>(std::atoi(argv[i + 1]));
+                else if (std::strcmp(argv[i], "--trace") == 0)
+                        Profiler::DumpTraceAtExit(argv[i + 1]);
+                else if (std::strcmp(argv[i], "--record") == 0)
+                        record_path = argv[i + 1];
+                else if (std::strcmp(argv[i], "--fps") == 0)
+                        fps = std::atof(argv[i + 1]);
+                else if (std::strcmp(argv[i], "--tick") == 0)
+                        tick = std::atof(argv[i + 1]);
+                else if (std::strcmp(argv[i], "--frames") == 0)
+                        record_frames = std::atoi(argv[i + 1]);
+                else if (std::strcmp(argv[i], "--mesh") == 0)
+                        mesh_path = argv[i + 1];
+                else if (std::strcmp(argv[i], "--save-mesh") == 0)
+                        save_mesh_path = argv[i + 1];
+                else if (std::strcmp(argv[i], "--field") == 0)
+                        field = std::atoi(argv[i + 1]);
+                else if (std::strcmp(argv[i], "--shade") == 0)
+                        shade = std::strcmp(argv[i + 1], "gouraud") == 0
+                                    ? ShadeMode::Gouraud
+                                : std::strcmp(argv[i + 1], "flat") == 0
+                                    ? ShadeMode::Flat
+                                    : ShadeMode::Solid;
+                else if (std::strcmp(argv[i], "--positions") == 0)
+                        format = std::strcmp(argv[i + 1], "q16") == 0
+                                     ? PositionFormat::Quantized16
+                                 : std::strcmp(argv[i + 1], "f32") == 0
+                                     ? PositionFormat::Float32
+                                     : PositionFormat::Float64;
+        }
+
+        Orbit orbit;
+        if (mesh_path) {
+                verts.clear();
+                tris.clear();
+                if (!LoadMeshFile(mesh_path, verts, tris)) {
+                        std::fprintf(stderr, "%s: could not load mesh\n",
+                                     mesh_path);
+                        return 1;
+                }
+                orbit = Orbit::Fit(verts);
+        }
+        if (save_mesh_path) {
+                if (!MeshIO::SaveMesh(save_mesh_path, verts, tris)) {
+                        std::perror(save_mesh_path);
+                        return 1;
+                }
+                std::fprintf(stderr, "Saved %zu vertices, %zu triangles to %s\n",
+                             verts.size(), tris.size(), save_mesh_path);
+                return 0;
+        }
+        const CompactMesh mesh = CompactMesh::Build(verts, tris, format);
+        const Vec3_t target = orbit.target;
+        std::unique_ptr<ParallelRasterizer> raster;
+        if (threads > 1)
+                raster = std::make_unique<ParallelRasterizer>(threads);
+
+        SceneGraph field_scene;
+        if (field > 0)
+                BuildField(field_scene, verts, tris, orbit, field);
+        DemoScene scene(mesh);
+        scene.field = field > 0 ? &field_scene : nullptr;
+        scene.raster = raster.get();
+        scene.front_to_back = front_to_back;
+        scene.shade = shade;
+
+        if (record_path)
+                return RecordHeadless(record_path, record_frames, scene, orbit);
+
+        // The spin is simulated on fixed ticks and drawn interpolated
+        // between the last two; the arrows and mouse add `offset` directly
+        double spin = 0.0, spin_prev = 0.0, offset = 0.0;
         bool paused = false;
+        FramePacer pacer(fps, tick);
+        Profiler::budget_ns = pacer.period_ns();
+
+        std::atexit(OnExit);
+        Terminal::InitTerminal(mouse);
 
-        Terminal::InitTerminal();
+        // Frames are written to the terminal on a separate thread. The
+        // scene is drawn into `canvas`, which keeps what was last drawn so
+        // unchanged frames are neither rendered nor published. Per-frame
+        // temporaries come from `arena`, so once warmed up the loop makes no
+        // heap allocations. All terminal output goes through the presenter,
+        // the too-small warning included, so nothing interleaves a frame.
+        const std::string too_small_message =
+            "⛔ Terminal too small. Resize to at least " +
+            std::to_string(CameraSettings::min_screen_width) + "x" +
+            std::to_string(CameraSettings::min_screen_height) + ".\n";
+        FrameIO::AsyncPresenter presenter;
+        Frame canvas;
+        FrameArena arena;
+        DebugUI::OverlayLines overlay;
+        bool warned = false;
+
+        // Every frame ends here: frames that put nothing new on screen
+        // (idle, resized, too small) are dropped from the profile, and all
+        // of them wait for the next deadline
+        auto end_frame = [&](bool drawn) {
+                if (drawn)
+                        Profiler::EndFrame();
+                else
+                        Profiler::DiscardFrame();
+                pacer.Wait();
+        };
 
         while (true) {
                 auto now = Clock::now();
                 double dt = std::chrono::duration<double>(now - last).count();
                 last = now;
+                const int ticks = pacer.BeginFrame();
 
-                Terminal::PollKeys();
-                Terminal::UpdateTerminalSize();
-                bool resized = Terminal::DidTerminalResize();
+                Profiler::BeginFrame();
+                arena.Reset();
+                bool resized;
+                {
+                        PROFILE_SCOPE(Input);
+                        Terminal::PollKeys();
+                        Terminal::UpdateTerminalSize();
+                        resized = Terminal::DidTerminalResize();
+                }
 
                 if (Terminal::too_small) {
-                        std::cout << "\033[2J\033[H";
-                        std::cout
-                            << "⛔ Terminal too small. Resize to at least "
-                            << CameraSettings::screen_width << "x"
-                            << CameraSettings::screen_height << ".\n";
-                        std::this_thread::sleep_for(
-                            std::chrono::milliseconds(200));
+                        if (!warned || resized)
+                                presenter.ShowMessage(
+                                    too_small_message.c_str());
+                        warned = true;
+                        end_frame(false);
                         continue;
                 }
 
+                warned = false;
+
                 if (resized) {
-                        FrameIO::ClearFramebuffer(front);
-                        FrameIO::ClearFramebuffer(back);
-                        FrameIO::ClearZBuffer(zbuf);
-                        std::cout << "\033[2J\033[H";
+                        zbuf.Resize(Terminal::term_width,
+                                    Terminal::term_height);
+                        canvas.Resize(zbuf.width(), zbuf.height());
+                        scene.Invalidate();
+                        presenter.Invalidate(canvas.width(), canvas.height());
+                        end_frame(false);
                         continue;
                 }
 
@@ -77,34 +444,70 @@ int main() {
                         break;
                 if (Terminal::WasKeyJustPressed(Key::SPACE))
                         paused = !paused;
+                if (Terminal::WasKeyJustPressed(Key::M))
+                        scene.NextMode();
+                if (Terminal::WasKeyJustPressed(Key::L))
+                        scene.NextShade();
+
+                // Arrows and left-drags orbit, the wheel zooms
+                if (Terminal::IsKeyPressed(Key::ARROW_LEFT))
+                        offset -= 0.1;
+                if (Terminal::IsKeyPressed(Key::ARROW_RIGHT))
+                        offset += 0.1;
+                if (Terminal::IsKeyPressed(Key::ARROW_UP))
+                        orbit.Raise(0.5);
+                if (Terminal::IsKeyPressed(Key::ARROW_DOWN))
+                        orbit.Raise(-0.5);
+                if (Terminal::IsKeyPressed(Key::MOUSE_LEFT)) {
+                        offset -= Terminal::mouse.dx * 0.05;
+                        orbit.Raise(Terminal::mouse.dy * 0.25);
+                }
+                orbit.Zoom(Terminal::mouse.wheel);
 
 #if DEBUG_ENABLED
                 if (Terminal::WasKeyJustPressed(Key::D))
                         DebugUI::Toggle();
 #endif
 
-                if (!paused)
-                        angle += dt * 0.75;
-
-                Vec3_t eye = {std::sin(angle) * 6.0, 3.0,
-                              std::cos(angle) * 6.0};
+                for (int t = 0; t < ticks; ++t) {
+                        spin_prev = spin;
+                        if (!paused)
+                                spin += pacer.tick_seconds() * 0.75;
+                }
 
-                FrameIO::ClearFramebuffer(back);
-                FrameIO::ClearZBuffer(zbuf);
+                Vec3_t eye = orbit.Eye(
+                    spin_prev + (spin - spin_prev) * pacer.alpha() + offset);
 
-                RenderMeshComposite(verts, tris, eye, target, back, zbuf, '.',
-                                    '*');
+                const bool drew = scene.Render(eye, target, canvas, zbuf);
 
+                DebugUI::OverlayLines lines(arena.resource());
 #if DEBUG_ENABLED
-                DebugUI::Draw(back, eye, target, 1.0 / dt);
+                lines = DebugUI::Lines(eye, target, 1.0 / dt,
+                                       presenter.last_bytes(),
+                                       arena.resource());
+                DebugUI::AppendPacing(lines, pacer.period_ns(), pacer.missed(),
+                                      pacer.worst_late_ns());
 #endif
 
-                if (!FrameIO::CompareBuffers(front, back)) {
-                        FrameIO::RenderChangedLines(back, front);
-                        FrameIO::CopyBuffer(front, back);
+                // Paused, or nothing moved: the screen already shows this
+                if (!drew && lines == overlay) {
+                        end_frame(false);
+                        continue;
+                }
+                overlay = lines; // reuses the capacity of the last copy
+
+                Frame &back = presenter.back();
+                FrameIO::CopyBuffer(back, canvas);
+
+#if DEBUG_ENABLED
+                {
+                        PROFILE_SCOPE(Overlay);
+                        DebugUI::Draw(back, overlay);
                 }
+#endif
 
-                std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                presenter.Publish();
+                end_frame(true);
         }
 
         return 0;
@@ -0,0 +1,137 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+
+// ─────────────────────────────────────────────
+// Aligned SoA lane storage
+// ─────────────────────────────────────────────
+//
+// All lanes of a buffer share one allocation. Each lane starts on a
+// SOA_ALIGNMENT boundary and its capacity (the lane stride) is padded to a
+// whole cache line of elements (SOA_LANE_PAD for doubles), so a full-width
+// vector load that starts inside a lane never leaves the allocation.
+//
+// resize() does not initialize new elements; callers are expected to write
+// every element they grow into (the batch kernels do).
+//
+// Adopt() points the lanes at storage owned elsewhere (a mapped mesh file);
+// the first reallocation copies it into a fresh allocation of our own.
+
+inline constexpr size_t SOA_ALIGNMENT = 64;
+inline constexpr size_t SOA_LANE_PAD = SOA_ALIGNMENT / sizeof(double);
+
+template <size_t LaneCount, typename T = double>
+class AlignedLanes {
+public:
+    using value_type = T;
+    static constexpr size_t LANE_PAD = SOA_ALIGNMENT / sizeof(T);
+
+    AlignedLanes() = default;
+
+    AlignedLanes(const AlignedLanes& other) { CopyFrom(other); }
+
+    AlignedLanes(AlignedLanes&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          stride_(std::exchange(other.stride_, 0)),
+          owner_(std::move(other.owner_)) {}
+
+    AlignedLanes& operator=(const AlignedLanes& other) {
+        if (this != &other) CopyFrom(other);
+        return *this;
+    }
+
+    AlignedLanes& operator=(AlignedLanes&& other) noexcept {
+        if (this != &other) {
+            Release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            stride_ = std::exchange(other.stride_, 0);
+            owner_ = std::move(other.owner_);
+        }
+        return *this;
+    }
+
+    ~AlignedLanes() { Release(); }
+
+    inline size_t size() const { return size_; }
+    inline size_t capacity() const { return stride_; }
+
+    inline std::span<T> lane(size_t k) { return {data_ + k * stride_, size_}; }
+    inline std::span<const T> lane(size_t k) const { return {data_ + k * stride_, size_}; }
+
+    inline void clear() { size_ = 0; }
+
+    void reserve(size_t count) {
+        if (count <= stride_) return;
+        const size_t stride = (count + LANE_PAD - 1) / LANE_PAD * LANE_PAD;
+        T* data = static_cast<T*>(::operator new(
+            LaneCount * stride * sizeof(T), std::align_val_t{SOA_ALIGNMENT}));
+        if (size_ > 0)
+            for (size_t k = 0; k < LaneCount; ++k)
+                std::memcpy(data + k * stride, data_ + k * stride_, size_ * sizeof(T));
+        Release();
+        data_ = data;
+        stride_ = stride;
+    }
+
+    inline void resize(size_t count) {
+        if (count > stride_) Grow(count);
+        size_ = count;
+    }
+
+    template <typename... Values>
+    inline void push_back(Values... values) {
+        static_assert(sizeof...(Values) == LaneCount, "one value per lane");
+        if (size_ == stride_) Grow(size_ + 1);
+        size_t k = 0;
+        ((data_[k++ * stride_ + size_] = static_cast<T>(values)), ...);
+        ++size_;
+    }
+
+    // Use `count` elements per lane at `data` (lane k at data + k * stride)
+    // without copying. `stride` must be a multiple of LANE_PAD and `data`
+    // SOA_ALIGNMENT-aligned; `owner` keeps the storage alive.
+    void Adopt(T* data, size_t count, size_t stride, std::shared_ptr<void> owner) {
+        Release();
+        data_ = data;
+        size_ = count;
+        stride_ = stride;
+        owner_ = std::move(owner);
+    }
+
+    inline bool borrowed() const { return owner_ != nullptr; }
+
+private:
+    inline void Grow(size_t count) { reserve(std::max(count, stride_ * 2)); }
+
+    void CopyFrom(const AlignedLanes& other) {
+        if (owner_) Release(); // never write through into adopted storage
+        size_ = 0;
+        reserve(other.size_);
+        if (other.size_ > 0)
+            for (size_t k = 0; k < LaneCount; ++k)
+                std::memcpy(data_ + k * stride_, other.data_ + k * other.stride_,
+                            other.size_ * sizeof(T));
+        size_ = other.size_;
+    }
+
+    void Release() {
+        if (owner_)
+            owner_.reset();
+        else if (data_)
+            ::operator delete(data_, std::align_val_t{SOA_ALIGNMENT});
+        data_ = nullptr;
+        stride_ = 0;
+    }
+
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t stride_ = 0; // padded per-lane capacity, in elements
+    std::shared_ptr<void> owner_; // set when the storage is adopted
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include "FrameBuffer.hpp"
+#include "FrameProfiler.hpp"
+#include "Surface.hpp"
+#include "TripleBuffer.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <unistd.h>
+
+namespace FrameIO {
+
+// ─────────────────────────────────────────────
+// Asynchronous presenter
+// ─────────────────────────────────────────────
+//
+// Terminal output runs on its own thread. The renderer draws into back()
+// and calls Publish(); the present thread picks up the newest published
+// frame through a triple buffer, diffs it against what it last put on
+// screen and writes it out. Rendering frame N+1 overlaps writing frame N,
+// and frames published while the terminal is still draining are dropped
+// rather than queued.
+//
+// The present thread times each present (diff/encode vs. write) and hands
+// the numbers back through a seqlock; Publish() folds the newest ones into
+// the frame thread's profile.
+
+class AsyncPresenter {
+public:
+    explicit AsyncPresenter(int fd = STDOUT_FILENO)
+        : presenter_(fd), thread_([this] { Run(); }) {}
+
+    ~AsyncPresenter() {
+        stop_.store(true, std::memory_order_relaxed);
+        Wake();
+        thread_.join();
+    }
+
+    AsyncPresenter(const AsyncPresenter&) = delete;
+    AsyncPresenter& operator=(const AsyncPresenter&) = delete;
+
+    // Renderer side: the frame to draw next (size it before drawing)
+    inline Frame& back() { return frames_.back(); }
+
+    inline void Publish() {
+        CollectTiming();
+        if (frames_.Publish())
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        Wake();
+    }
+
+    // Clear the screen and fully redraw, after a resize, at the new frame
+    // size: the current frame if it already has that size, otherwise the
+    // first one published at it. Frames of any other size are not shown.
+    inline void Invalidate(int width, int height) {
+        invalidate_width_.store(width, std::memory_order_relaxed);
+        invalidate_height_.store(height, std::memory_order_relaxed);
+        invalidate_.store(true, std::memory_order_release);
+        Wake();
+    }
+
+    // Replace the screen with `text` (which must outlive the presenter)
+    // until the next frame, which is then redrawn in full. Goes through the
+    // present thread so it never lands in the middle of a frame.
+    inline void ShowMessage(const char* text) {
+        message_.store(text, std::memory_order_release);
+        Wake();
+    }
+
+    inline size_t last_bytes() const { return last_bytes_.load(std::memory_order_relaxed); }
+    inline uint64_t presented() const { return presented_.load(std::memory_order_relaxed); }
+    inline uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    inline void Wake() {
+        sequence_.fetch_add(1, std::memory_order_release);
+        sequence_.notify_one();
+    }
+
+    void Run() {
+        uint64_t seen = 0;
+        while (true) {
+            sequence_.wait(seen, std::memory_order_acquire);
+            seen = sequence_.load(std::memory_order_acquire);
+            if (stop_.load(std::memory_order_relaxed)) return;
+
+            if (const char* text = message_.exchange(nullptr, std::memory_order_acquire)) {
+                presenter_.ShowMessage(text);
+                shown_.Resize(0, 0);
+                continue;
+            }
+
+            const bool redraw = invalidate_.exchange(false, std::memory_order_acquire);
+            if (redraw) {
+                presenter_.ClearScreen();
+                shown_.Resize(0, 0); // forces a full redraw
+                expect_width_ = invalidate_width_.load(std::memory_order_relaxed);
+                expect_height_ = invalidate_height_.load(std::memory_order_relaxed);
+            }
+            // After a clear, redraw the current frame even if nothing new came in
+            if (!frames_.Acquire() && !redraw) continue;
+
+            const Frame& frame = frames_.front();
+            if (expect_width_ >= 0) {
+                // Drawn before the resize: wait for one at the new size
+                if (frame.width() != expect_width_ || frame.height() != expect_height_)
+                    continue;
+                expect_width_ = expect_height_ = -1;
+            }
+            const int64_t begin = Profiler::Now();
+            const size_t bytes = presenter_.Present(frame, shown_);
+            const int64_t total = Profiler::Now() - begin;
+            if (bytes > 0) CopyBuffer(shown_, frame);
+            PublishTiming(begin, total - presenter_.last_write_ns(), presenter_.last_write_ns());
+            last_bytes_.store(bytes, std::memory_order_relaxed);
+            presented_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Seqlock writer (present thread): odd sequence while fields are in flux
+    void PublishTiming(int64_t begin, int64_t diff, int64_t write) {
+        const uint64_t seq = timing_seq_.load(std::memory_order_relaxed);
+        timing_seq_.store(seq + 1, std::memory_order_relaxed);
+        timing_[0].store(begin, std::memory_order_release);
+        timing_[1].store(diff, std::memory_order_release);
+        timing_[2].store(write, std::memory_order_release);
+        timing_seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Seqlock reader (frame thread): records each completed present once
+    void CollectTiming() {
+        const uint64_t seq = timing_seq_.load(std::memory_order_acquire);
+        if (seq == timing_seen_ || (seq & 1)) return;
+        const int64_t begin = timing_[0].load(std::memory_order_acquire);
+        const int64_t diff = timing_[1].load(std::memory_order_acquire);
+        const int64_t write = timing_[2].load(std::memory_order_acquire);
+        if (timing_seq_.load(std::memory_order_relaxed) != seq) return;
+        timing_seen_ = seq;
+        Profiler::Record(Profiler::Stage::Diff, begin, diff);
+        Profiler::Record(Profiler::Stage::Present, begin + diff, write);
+    }
+
+    TripleBuffer<Frame> frames_;
+    FramePresenter presenter_;
+    Frame shown_; // what is currently on screen (present thread only)
+    // Frame size awaited after an Invalidate, -1 when any will do (present
+    // thread only)
+    int expect_width_ = -1;
+    int expect_height_ = -1;
+
+    std::atomic<uint64_t> sequence_{0};
+    std::atomic<bool> invalidate_{false};
+    std::atomic<int> invalidate_width_{0};
+    std::atomic<int> invalidate_height_{0};
+    std::atomic<const char*> message_{nullptr};
+    std::atomic<bool> stop_{false};
+    std::atomic<size_t> last_bytes_{0};
+    std::atomic<uint64_t> presented_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    std::atomic<uint64_t> timing_seq_{0};
+    std::atomic<int64_t> timing_[3] = {};
+    uint64_t timing_seen_ = 0; // frame thread only
+
+    std::thread thread_; // last: starts after everything above is built
+};
+
+} // namespace FrameIO
@@ -3,7 +3,6 @@
 #include "VectorOperations.hpp"
 #include "CameraSettings.hpp"
 #include <cmath>
-#include <cassert>
 
 constexpr Vec3_t CAMERA_UP = {0.0, 1.0, 0.0};
 
@@ -40,9 +39,9 @@ inline void WorldToCamera(const Vec3Buffer& world,
                           const CameraView_t& view,
                           const Vec3_t& eye,
                           Vec3Buffer& out) {
-    double rx = world.x[wi] - eye.x;
-    double ry = world.y[wi] - eye.y;
-    double rz = world.z[wi] - eye.z;
+    double rx = world.x()[wi] - eye.x;
+    double ry = world.y()[wi] - eye.y;
+    double rz = world.z()[wi] - eye.z;
     out.push_back(
         rx * view.right.x + ry * view.right.y + rz * view.right.z,
         rx * view.up.x    + ry * view.up.y    + rz * view.up.z,
@@ -55,12 +54,12 @@ inline void ProjectToScreen(const Vec3Buffer& cam,
                             double focal_length,
                             double aspect_ratio,
                             Vec2Buffer& out) {
-    assert(cam.z[ci] > 0.0 && "Point is behind the camera!");
-    double inv_z = 1.0 / cam.z[ci];
+    PARANOID_CHECK(cam.z()[ci] > 0.0, "Point is behind the camera!");
+    double inv_z = 1.0 / cam.z()[ci];
     double fx = (focal_length / aspect_ratio) * CameraSettings::pixel_aspect;
     out.push_back(
-        cam.x[ci] * inv_z * fx,
-        cam.y[ci] * inv_z * focal_length
+        cam.x()[ci] * inv_z * fx,
+        cam.y()[ci] * inv_z * focal_length
     );
 }
 
@@ -69,11 +68,90 @@ inline Int2_t MapToScreen(const Vec2Buffer& proj,
                           int screen_width,
                           int screen_height) {
     constexpr double half = 0.5;
-    double x_ndc = (proj.x[pi] + 1.0) * half;
-    double y_ndc = 1.0 - ((proj.y[pi] + 1.0) * half);
+    double x_ndc = (proj.x()[pi] + 1.0) * half;
+    double y_ndc = 1.0 - ((proj.y()[pi] + 1.0) * half);
     int xi = static_cast<int>(std::round(x_ndc * screen_width));
     int yi = static_cast<int>(std::round(y_ndc * screen_height));
     xi = std::clamp(xi, 0, screen_width - 1);
     yi = std::clamp(yi, 0, screen_height - 1);
     return { xi, yi };
 }
+
+// Same mapping as MapToScreen, but keeps the subpixel position and does not
+// clamp; the rasterizer snaps and clips on its own.
+inline Vec2_t MapToScreenSubpixel(const Vec2Buffer& proj,
+                                  size_t pi,
+                                  int screen_width,
+                                  int screen_height) {
+    constexpr double half = 0.5;
+    double x_ndc = (proj.x()[pi] + 1.0) * half;
+    double y_ndc = 1.0 - ((proj.y()[pi] + 1.0) * half);
+    return { x_ndc * screen_width, y_ndc * screen_height };
+}
+
+// ─────────────────────────────────────────────
+// View frustum
+// ─────────────────────────────────────────────
+//
+// World-space planes bounding what the transform stage maps into [-1, 1]
+// projected space, plus the eye plane (cam.z > 0). There is no far plane:
+// the renderers draw at any depth. A point p is inside a plane when
+// dot(normal, p) + d >= 0; normals are unit length, so the same value is a
+// signed distance for sphere tests.
+
+struct Plane_t {
+    Vec3_t normal;
+    double d;
+};
+
+struct Frustum_t {
+    static constexpr size_t PLANE_COUNT = 5; // left, right, bottom, top, eye
+    Plane_t planes[PLANE_COUNT];
+
+    inline bool IntersectsSphere(const Vec3_t& center, double radius) const {
+        for (const Plane_t& p : planes)
+            if (VecDotAtomic(p.normal, center) + p.d < -radius) return false;
+        return true;
+    }
+
+    // Box given by center and half extents; tests the corner furthest along
+    // each plane normal
+    inline bool IntersectsBox(const Vec3_t& center, const Vec3_t& extent) const {
+        for (const Plane_t& p : planes) {
+            const double reach = std::abs(p.normal.x) * extent.x +
+                                 std::abs(p.normal.y) * extent.y +
+                                 std::abs(p.normal.z) * extent.z;
+            if (VecDotAtomic(p.normal, center) + p.d < -reach) return false;
+        }
+        return true;
+    }
+};
+
+// Frustum of the view built by LookAt, for the projection used by
+// TransformToScreenBatch
+inline Frustum_t BuildFrustum(const CameraView_t& view,
+                              const Vec3_t& eye,
+                              double focal_length,
+                              double aspect_ratio) {
+    const double fx = (focal_length / aspect_ratio) * CameraSettings::pixel_aspect;
+
+    // Camera-space normals: |proj.x| <= 1 is |cam.x * fx| <= cam.z, etc.
+    const Vec3_t cam_normals[Frustum_t::PLANE_COUNT] = {
+        { fx, 0.0, 1.0},
+        {-fx, 0.0, 1.0},
+        {0.0,  focal_length, 1.0},
+        {0.0, -focal_length, 1.0},
+        {0.0, 0.0, 1.0},
+    };
+
+    Frustum_t frustum;
+    for (size_t i = 0; i < Frustum_t::PLANE_COUNT; ++i) {
+        const Vec3_t& n = cam_normals[i];
+        const Vec3_t world = VecNormalizeAtomic({
+            n.x * view.right.x + n.y * view.up.x + n.z * view.forward.x,
+            n.x * view.right.y + n.y * view.up.y + n.z * view.forward.y,
+            n.x * view.right.z + n.y * view.up.z + n.z * view.forward.z});
+        frustum.planes[i] = {world, -VecDotAtomic(world, eye)};
+    }
+    return frustum;
+}
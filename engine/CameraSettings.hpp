@@ -3,8 +3,12 @@
 #include <cmath>
 
 namespace CameraSettings {
+// Default surface size; interactive demos follow the terminal size instead
 constexpr int screen_width = 212;
 constexpr int screen_height = 49;
+// Smallest terminal the demos will render into
+constexpr int min_screen_width = 40;
+constexpr int min_screen_height = 12;
 constexpr double PI = 3.14159265358979323846;
 constexpr double aspect_ratio =
     static_cast<double>(screen_width) / screen_height;
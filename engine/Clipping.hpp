@@ -0,0 +1,125 @@
+#pragma once
+#include "DataTypes.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// ─────────────────────────────────────────────
+// Polygon and line clipping
+// ─────────────────────────────────────────────
+//
+// Triangles are clipped against the near plane in camera space, where a
+// vertex behind the eye still has a meaningful position, and against the
+// guard band in screen space, where 1/z is affine and can be interpolated
+// directly. Both use Sutherland-Hodgman, which keeps the winding. Lines are
+// clipped to a screen rectangle with Cohen-Sutherland outcodes.
+
+// Screen-space clip vertex: subpixel position and camera depth
+struct ClipVertex_t {
+    double x, y, z;
+};
+
+// A triangle gains at most one vertex per clip plane: the near plane, then
+// the four guard band edges
+constexpr size_t MAX_CLIP_VERTICES = 3 + 1 + 4;
+
+// Inclusive rectangle
+struct ClipRect_t {
+    double x0, y0, x1, y1;
+};
+
+enum : uint8_t {
+    CLIP_LEFT = 1,
+    CLIP_RIGHT = 2,
+    CLIP_TOP = 4,
+    CLIP_BOTTOM = 8
+};
+
+inline uint8_t Outcode(double x, double y, const ClipRect_t& r) {
+    uint8_t code = 0;
+    if (x < r.x0) code |= CLIP_LEFT;
+    else if (x > r.x1) code |= CLIP_RIGHT;
+    if (y < r.y0) code |= CLIP_TOP;
+    else if (y > r.y1) code |= CLIP_BOTTOM;
+    return code;
+}
+
+// One Sutherland-Hodgman pass: keeps the part of `in` where dist(v) >= 0.
+// `lerp(a, b, t)` builds the crossing vertex. Returns the vertex count.
+template <typename V, typename Dist, typename Lerp>
+inline size_t ClipPolygonPlane(const V* in, size_t n, Dist&& dist, Lerp&& lerp, V* out) {
+    size_t m = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const V& a = in[i];
+        const V& b = in[(i + 1) % n];
+        const double da = dist(a), db = dist(b);
+        if (da >= 0.0) out[m++] = a;
+        if ((da >= 0.0) != (db >= 0.0)) out[m++] = lerp(a, b, da / (da - db));
+    }
+    return m;
+}
+
+// Clip a camera-space polygon to z >= near; crossing vertices land exactly
+// on the plane
+inline size_t ClipPolygonNear(const Vec3_t* in, size_t n, double near, Vec3_t* out) {
+    return ClipPolygonPlane(in, n,
+        [&](const Vec3_t& v) { return v.z - near; },
+        [&](const Vec3_t& a, const Vec3_t& b, double t) {
+            return Vec3_t{a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, near};
+        },
+        out);
+}
+
+// Clip a screen-space polygon to `r` in place (`poly` must hold
+// MAX_CLIP_VERTICES). Depth is interpolated as 1/z.
+inline size_t ClipPolygonRect(ClipVertex_t* poly, size_t n, const ClipRect_t& r) {
+    auto lerp = [](const ClipVertex_t& a, const ClipVertex_t& b, double t) {
+        const double inv_z = 1.0 / a.z + (1.0 / b.z - 1.0 / a.z) * t;
+        return ClipVertex_t{a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, 1.0 / inv_z};
+    };
+    ClipVertex_t scratch[MAX_CLIP_VERTICES];
+    ClipVertex_t* src = poly;
+    ClipVertex_t* dst = scratch;
+    auto pass = [&](auto&& dist) {
+        if (n == 0) return;
+        n = ClipPolygonPlane(src, n, dist, lerp, dst);
+        std::swap(src, dst);
+    };
+    pass([&](const ClipVertex_t& v) { return v.x - r.x0; });
+    pass([&](const ClipVertex_t& v) { return r.x1 - v.x; });
+    pass([&](const ClipVertex_t& v) { return v.y - r.y0; });
+    pass([&](const ClipVertex_t& v) { return r.y1 - v.y; });
+    if (src != poly)
+        for (size_t i = 0; i < n; ++i) poly[i] = src[i];
+    return n;
+}
+
+// Cohen-Sutherland: clip segment a-b to `r` in place. Returns false if no
+// part of it is inside.
+inline bool ClipLine(Vec2_t& a, Vec2_t& b, const ClipRect_t& r) {
+    uint8_t ca = Outcode(a.x, a.y, r);
+    uint8_t cb = Outcode(b.x, b.y, r);
+    while (ca | cb) {
+        if (ca & cb) return false;
+        const uint8_t code = ca ? ca : cb;
+        Vec2_t p;
+        if (code & CLIP_TOP) {
+            p = {a.x + (b.x - a.x) * (r.y0 - a.y) / (b.y - a.y), r.y0};
+        } else if (code & CLIP_BOTTOM) {
+            p = {a.x + (b.x - a.x) * (r.y1 - a.y) / (b.y - a.y), r.y1};
+        } else if (code & CLIP_LEFT) {
+            p = {r.x0, a.y + (b.y - a.y) * (r.x0 - a.x) / (b.x - a.x)};
+        } else {
+            p = {r.x1, a.y + (b.y - a.y) * (r.x1 - a.x) / (b.x - a.x)};
+        }
+        if (code == ca) {
+            a = p;
+            ca = Outcode(a.x, a.y, r);
+        } else {
+            b = p;
+            cb = Outcode(b.x, b.y, r);
+        }
+    }
+    return true;
+}
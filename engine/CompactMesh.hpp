@@ -0,0 +1,157 @@
+#pragma once
+#include "AlignedLanes.hpp"
+#include "DataTypes.hpp"
+#include "MeshNormals.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <variant>
+
+// ─────────────────────────────────────────────
+// Compact mesh storage
+// ─────────────────────────────────────────────
+//
+// Bytes per vertex / per triangle:
+//
+//   Vec3Buffer           24    TriangleBuffer     12  (uint32_t)
+//   Vec3BufferF32        12    TriangleBuffer16    6  (uint16_t, <= 65536 verts)
+//   QuantizedVec3Buffer   6
+//
+// The transform stage reads every format directly and widens to double as it
+// loads (see TransformToScreenBatch), so nothing is expanded in memory.
+
+// --- float32 positions ---
+struct Vec3BufferF32 {
+    AlignedLanes<3, float> lanes;
+
+    inline std::span<float> x() { return lanes.lane(0); }
+    inline std::span<float> y() { return lanes.lane(1); }
+    inline std::span<float> z() { return lanes.lane(2); }
+    inline std::span<const float> x() const { return lanes.lane(0); }
+    inline std::span<const float> y() const { return lanes.lane(1); }
+    inline std::span<const float> z() const { return lanes.lane(2); }
+
+    inline void clear() { lanes.clear(); }
+    inline void reserve(size_t count) { lanes.reserve(count); }
+    inline void push_back(double xi, double yi, double zi) { lanes.push_back(xi, yi, zi); }
+    inline size_t size() const { return lanes.size(); }
+
+    static Vec3BufferF32 From(const Vec3Buffer& src) {
+        Vec3BufferF32 out;
+        out.lanes.resize(src.size());
+        std::copy(src.x().begin(), src.x().end(), out.x().begin());
+        std::copy(src.y().begin(), src.y().end(), out.y().begin());
+        std::copy(src.z().begin(), src.z().end(), out.z().begin());
+        return out;
+    }
+};
+
+// --- 16-bit quantized positions: world = offset + q * scale, per axis ---
+struct QuantizedVec3Buffer {
+    static constexpr double LEVELS = 65535.0;
+
+    AlignedLanes<3, uint16_t> lanes;
+    Vec3_t offset = {0.0, 0.0, 0.0}; // bounding box minimum
+    Vec3_t scale = {1.0, 1.0, 1.0};  // world units per step
+
+    inline std::span<const uint16_t> x() const { return lanes.lane(0); }
+    inline std::span<const uint16_t> y() const { return lanes.lane(1); }
+    inline std::span<const uint16_t> z() const { return lanes.lane(2); }
+    inline size_t size() const { return lanes.size(); }
+
+    inline Vec3_t At(size_t i) const {
+        return {offset.x + x()[i] * scale.x,
+                offset.y + y()[i] * scale.y,
+                offset.z + z()[i] * scale.z};
+    }
+
+    // Quantizes over the bounding box; the error is at most half a step
+    // (extent / 131070) per axis
+    static QuantizedVec3Buffer Quantize(const Vec3Buffer& src) {
+        QuantizedVec3Buffer out;
+        if (src.size() == 0) return out;
+
+        auto axis = [&](std::span<const double> in, std::span<uint16_t> q,
+                        double& offset, double& scale) {
+            const auto [lo, hi] = std::minmax_element(in.begin(), in.end());
+            offset = *lo;
+            scale = *hi > *lo ? (*hi - *lo) / LEVELS : 1.0;
+            for (size_t i = 0; i < in.size(); ++i)
+                q[i] = static_cast<uint16_t>(std::lround((in[i] - offset) / scale));
+        };
+        out.lanes.resize(src.size());
+        axis(src.x(), out.lanes.lane(0), out.offset.x, out.scale.x);
+        axis(src.y(), out.lanes.lane(1), out.offset.y, out.scale.y);
+        axis(src.z(), out.lanes.lane(2), out.offset.z, out.scale.z);
+        return out;
+    }
+};
+
+enum class PositionFormat {
+    Float64,
+    Float32,
+    Quantized16
+};
+
+template <typename To, typename From>
+inline TriangleList<To> ConvertIndices(const TriangleList<From>& src) {
+    TriangleList<To> out;
+    out.indices.resize(src.size());
+    for (size_t t = 0; t < src.size(); ++t)
+        for (size_t k = 0; k < 3; ++k)
+            out.indices[t][k] = static_cast<To>(src.indices[t][k]);
+    return out;
+}
+
+// A mesh in whichever position format was asked for, with the narrowest
+// index type its vertex count allows. Visit() hands the concrete buffers to
+// a generic callable, e.g. a RenderMeshComposite call. Normals are built
+// once from the full-precision source, whatever the position format.
+struct CompactMesh {
+    std::variant<Vec3Buffer, Vec3BufferF32, QuantizedVec3Buffer> positions;
+    std::variant<TriangleBuffer16, TriangleBuffer> triangles;
+    MeshNormals normals;
+
+    static CompactMesh Build(const Vec3Buffer& verts,
+                             const TriangleBuffer& tris,
+                             PositionFormat format = PositionFormat::Float64) {
+        CompactMesh mesh;
+        switch (format) {
+        case PositionFormat::Float64: mesh.positions = verts; break;
+        case PositionFormat::Float32: mesh.positions = Vec3BufferF32::From(verts); break;
+        case PositionFormat::Quantized16: mesh.positions = QuantizedVec3Buffer::Quantize(verts); break;
+        }
+        if (verts.size() <= INDEX16_MAX_VERTICES)
+            mesh.triangles = ConvertIndices<uint16_t>(tris);
+        else
+            mesh.triangles = tris;
+        mesh.normals.Update(verts, tris);
+        return mesh;
+    }
+
+    inline size_t vertex_count() const {
+        return std::visit([](const auto& p) { return p.size(); }, positions);
+    }
+
+    inline size_t triangle_count() const {
+        return std::visit([](const auto& t) { return t.size(); }, triangles);
+    }
+
+    // Payload bytes (excluding lane padding)
+    inline size_t size_bytes() const {
+        const size_t vertex_bytes = std::visit([](const auto& p) {
+            return 3 * sizeof(typename std::decay_t<decltype(p.x())>::value_type);
+        }, positions);
+        const size_t index_bytes = std::visit([](const auto& t) {
+            return 3 * sizeof(typename std::decay_t<decltype(t)>::index_type);
+        }, triangles);
+        return vertex_count() * vertex_bytes + triangle_count() * index_bytes;
+    }
+
+    template <typename F>
+    inline decltype(auto) Visit(F&& f) const {
+        return std::visit(std::forward<F>(f), positions, triangles);
+    }
+};
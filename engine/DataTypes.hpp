@@ -1,7 +1,14 @@
 #pragma once
+#include "AlignedLanes.hpp"
+#include "Validation.hpp"
 #include <vector>
 #include <cstddef> // for size_t
 #include <array>
+#include <span>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
 
 
 // --- Integer 2D struct (not SoA, typically used for screen positions) ---
@@ -9,79 +16,128 @@ struct Int2_t {
     int x, y;
 };
 
+// --- Double 2D struct (subpixel screen positions) ---
+struct Vec2_t {
+    double x, y;
+};
+
 // AoS is still appropriate here because this is a single logical object
 struct Vec3_t {
     double x, y, z;
+
+    bool operator==(const Vec3_t&) const = default;
 };
 
+// Unique stamp for buffer contents; copies keep their source's stamp since
+// their contents are identical
+inline uint64_t NextBufferRevision() {
+    static std::atomic<uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 // Triangle index buffer (face layout)
-struct TriangleBuffer {
-    std::vector<std::array<size_t, 3>> indices;
+// `revision` changes on every mutation through the member functions; code
+// that edits `indices` directly must call touch() so derived data (e.g.
+// MeshTopology) is rebuilt.
+//
+// Indices are 32-bit by default (12 bytes per triangle); meshes with at most
+// INDEX16_MAX_VERTICES vertices can use TriangleBuffer16 (6 bytes).
+template <typename Index>
+struct TriangleList {
+    using index_type = Index;
+
+    std::vector<std::array<Index, 3>> indices;
+    uint64_t revision = NextBufferRevision();
 
-    inline void clear() { indices.clear(); }
+    inline void clear() { indices.clear(); touch(); }
 
     inline void push_back(size_t i0, size_t i1, size_t i2) {
-        indices.push_back({i0, i1, i2});
+        BOUNDARY_CHECK(std::max({i0, i1, i2}) <= std::numeric_limits<Index>::max(),
+                       "TRIANGLE LIST: index does not fit the index type");
+        indices.push_back({static_cast<Index>(i0), static_cast<Index>(i1), static_cast<Index>(i2)});
+        touch();
     }
 
     inline size_t size() const { return indices.size(); }
+
+    inline void touch() { revision = NextBufferRevision(); }
 };
 
+using TriangleBuffer = TriangleList<uint32_t>;
+using TriangleBuffer16 = TriangleList<uint16_t>;
+
+inline constexpr size_t INDEX16_MAX_VERTICES = size_t{1} << 16;
+
 
 // --- Struct of Arrays for 3D vectors ---
+// One aligned allocation holds all three lanes (see AlignedLanes.hpp), so
+// x, y and z always have the same length.
+// `revision` changes on every resize/push through the member functions;
+// code that writes through x()/y()/z() must call touch() so derived data
+// (e.g. MeshNormals) is rebuilt.
 struct Vec3Buffer {
-    std::vector<double> x;
-    std::vector<double> y;
-    std::vector<double> z;
+    AlignedLanes<3> lanes;
+    uint64_t revision = NextBufferRevision();
 
     Vec3Buffer() = default;
 
     Vec3Buffer(const Vec3_t* arr, size_t count) {
-    x.reserve(count);
-    y.reserve(count);
-    z.reserve(count);
-    for (size_t i = 0; i < count; ++i) {
-        x.push_back(arr[i].x);
-        y.push_back(arr[i].y);
-        z.push_back(arr[i].z);
+        lanes.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            lanes.push_back(arr[i].x, arr[i].y, arr[i].z);
     }
-  }
 
     static Vec3Buffer FromArray(const Vec3_t* arr, size_t count) {
       return Vec3Buffer(arr, count);
     }
 
-    inline void clear() {
-        x.clear(); y.clear(); z.clear();
-    }
+    inline std::span<double> x() { return lanes.lane(0); }
+    inline std::span<double> y() { return lanes.lane(1); }
+    inline std::span<double> z() { return lanes.lane(2); }
+    inline std::span<const double> x() const { return lanes.lane(0); }
+    inline std::span<const double> y() const { return lanes.lane(1); }
+    inline std::span<const double> z() const { return lanes.lane(2); }
+
+    inline void clear() { lanes.clear(); touch(); }
+
+    inline void reserve(size_t count) { lanes.reserve(count); }
+
+    // New elements are left uninitialized
+    inline void resize(size_t count) { lanes.resize(count); touch(); }
 
     inline void push_back(double xi, double yi, double zi) {
-        x.push_back(xi); y.push_back(yi); z.push_back(zi);
+        lanes.push_back(xi, yi, zi);
+        touch();
     }
 
-    inline size_t size() const {
-        return x.size(); // assume x, y, z are always the same length
-    }
+    inline size_t size() const { return lanes.size(); }
+
+    inline void touch() { revision = NextBufferRevision(); }
 };
 
 // --- Struct of Arrays for 2D vectors ---
 struct Vec2Buffer {
-    std::vector<double> x;
-    std::vector<double> y;
+    AlignedLanes<2> lanes;
 
     Vec2Buffer() = default;
 
-    inline void clear() {
-        x.clear(); y.clear();
-    }
+    inline std::span<double> x() { return lanes.lane(0); }
+    inline std::span<double> y() { return lanes.lane(1); }
+    inline std::span<const double> x() const { return lanes.lane(0); }
+    inline std::span<const double> y() const { return lanes.lane(1); }
+
+    inline void clear() { lanes.clear(); }
+
+    inline void reserve(size_t count) { lanes.reserve(count); }
+
+    // New elements are left uninitialized
+    inline void resize(size_t count) { lanes.resize(count); }
 
     inline void push_back(double xi, double yi) {
-        x.push_back(xi); y.push_back(yi);
+        lanes.push_back(xi, yi);
     }
 
-    inline size_t size() const {
-        return x.size();
-    }
+    inline size_t size() const { return lanes.size(); }
 };
 
 // --- Single camera frame, not SoA (represents 1 matrix transform) ---
@@ -93,17 +149,35 @@ struct CameraView_t {
     Vec3_t offset;  // translation: (-dot(right,eye), -dot(up,eye), -dot(forward,eye))
 };
 
+// --- Model-to-world transform of one instance, not SoA ---
+// world = position + x_axis * p.x + y_axis * p.y + z_axis * p.z
+// The axes are the columns of the rotation/scale matrix.
+struct ModelTransform_t {
+    Vec3_t x_axis = {1.0, 0.0, 0.0};
+    Vec3_t y_axis = {0.0, 1.0, 0.0};
+    Vec3_t z_axis = {0.0, 0.0, 1.0};
+    Vec3_t position = {0.0, 0.0, 0.0};
+};
+
 // Edge struct (undirected)
 struct Edge {
     size_t a, b;
     Edge(size_t i, size_t j) : a(std::min(i,j)), b(std::max(i,j)) {}
     bool operator==(const Edge& o) const { return a == o.a && b == o.b; }
+    bool operator<(const Edge& o) const { return a < o.a || (a == o.a && b < o.b); }
 };
 
 namespace std {
     template <> struct hash<Edge> {
+        // splitmix64 finalizer over both endpoints; a plain a ^ (b << 1)
+        // sends many small-index pairs to the same bucket
         size_t operator()(const Edge& e) const {
-            return std::hash<size_t>()(e.a) ^ (std::hash<size_t>()(e.b) << 1);
+            uint64_t h = static_cast<uint64_t>(e.a) * 0x9E3779B97F4A7C15ull
+                       ^ static_cast<uint64_t>(e.b);
+            h ^= h >> 30; h *= 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 27; h *= 0x94D049BB133111EBull;
+            h ^= h >> 31;
+            return static_cast<size_t>(h);
         }
     };
 }
@@ -3,11 +3,17 @@
 #include "TerminalControl.hpp"
 #include "KeyMap.hpp"
 #include "DataTypes.hpp"
+#include "FrameArena.hpp"
+#include "FrameProfiler.hpp"
+#include "Surface.hpp"
 
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <memory_resource>
+#include <sstream>
 #include <string>
 #include <vector>
-#include <sstream>
-#include <iomanip>
 
 #define DEBUG_ENABLED 1
 
@@ -42,42 +48,112 @@ inline std::string FormatVec3(const Vec3_t& v) {
     return oss.str();
 }
 
-// Update and draw debug info
-inline void Draw(
-    char (&fb)[CameraSettings::screen_height][CameraSettings::screen_width],
+// Overlay text. Built fresh every frame, so it is meant to be allocated
+// from a FrameArena; a copy kept across frames reuses its capacity.
+using OverlayLines = std::pmr::vector<std::pmr::string>;
+
+// Global allocations seen by the last Lines() call
+inline uint64_t heap_seen = 0;
+
+template <typename... Args>
+inline void AddLine(OverlayLines& lines, const char* format, Args... args) {
+    char line[128];
+    std::snprintf(line, sizeof(line), format, args...);
+    lines.emplace_back(line);
+}
+
+// Rolling per-stage timings, indented by stage depth
+inline void AppendProfile(OverlayLines& lines) {
+    if (Profiler::frames_recorded == 0) return;
+
+    lines.emplace_back(" Stage (ms)     p50    p99");
+    for (size_t s = 0; s < Profiler::STAGE_COUNT; ++s) {
+        const Profiler::StageStats stats = Profiler::Stats(static_cast<Profiler::Stage>(s));
+        if (stats.samples == 0) continue;
+        const int indent = 2 * Profiler::Depth(s);
+        AddLine(lines, "  %*s%-*s%7.2f%7.2f", indent, "", 12 - indent, Profiler::STAGES[s].name,
+                stats.p50_ns / 1e6, stats.p99_ns / 1e6);
+    }
+
+    if (Profiler::budget_misses > 0)
+        AddLine(lines, " Over budget: %llu (last %.1fms, %s)",
+                static_cast<unsigned long long>(Profiler::budget_misses),
+                Profiler::last_miss_ns / 1e6,
+                Profiler::STAGES[static_cast<size_t>(Profiler::last_miss_stage)].name);
+}
+
+// Overlay text for the current state, allocated from `arena`; empty while
+// hidden. Callers that skip unchanged frames compare it with what they
+// last drew. With COUNT_GLOBAL_ALLOCATIONS, also shows the heap allocations
+// made since the previous call, i.e. over the last frame.
+inline OverlayLines Lines(
     const Vec3_t& camera_pos,
     const Vec3_t& target,
-    double fps) {
+    double fps,
+    size_t present_bytes = 0,
+    std::pmr::memory_resource* arena = std::pmr::get_default_resource()) {
 
-    if (!show_debug) return;
+    const uint64_t heap = HeapStats::Allocations();
+    const uint64_t heap_frame = heap - heap_seen;
+    heap_seen = heap;
 
-    std::vector<std::string> lines;
+    OverlayLines lines(arena);
+    if (!show_debug) return lines;
 
     // Core status
-    lines.push_back("[Debug Info]");
-    lines.push_back(" FPS: " + std::to_string(static_cast<int>(fps)));
-    lines.push_back(" Eye: " + FormatVec3(camera_pos));
-    lines.push_back(" At : " + FormatVec3(target));
+    lines.emplace_back("[Debug Info]");
+    AddLine(lines, " FPS: %d", static_cast<int>(fps));
+    AddLine(lines, " Out: %zu B/frame", present_bytes);
+    AddLine(lines, " Eye: (%.2f, %.2f, %.2f)", camera_pos.x, camera_pos.y, camera_pos.z);
+    AddLine(lines, " At : (%.2f, %.2f, %.2f)", target.x, target.y, target.z);
+    if (HeapStats::counting)
+        AddLine(lines, " Heap: %llu allocs/frame", static_cast<unsigned long long>(heap_frame));
 
     // Input state
-    std::ostringstream keys;
-    keys << " Keys: ";
-    for (const auto& [code, down] : Terminal::key_state) {
-        if (down) keys << Terminal::PrintableChar(code) << " ";
+    std::pmr::string& keys = lines.emplace_back(" Keys: ");
+    for (int code = 0; code < Key::CODES; ++code) {
+        if (!Terminal::key_state[code]) continue;
+        keys += Terminal::PrintableChar(code); // short enough to stay inline
+        keys += ' ';
     }
-    lines.push_back(keys.str());
+
+    AppendProfile(lines);
 
     // Manual logs
-    for (const auto& line : debug_lines)
-        lines.push_back("> " + line);
+    for (const auto& line : debug_lines) {
+        std::pmr::string& log = lines.emplace_back("> ");
+        log += line;
+    }
+    return lines;
+}
+
+// Frame pacing target and missed deadlines (FramePacing.hpp); nothing
+// while the overlay is hidden
+inline void AppendPacing(OverlayLines& lines, int64_t period_ns, uint64_t missed,
+                         int64_t worst_late_ns) {
+    if (!show_debug) return;
+    AddLine(lines, " Pace: %.0f Hz, %llu missed (worst +%.1fms)", 1e9 / period_ns,
+            static_cast<unsigned long long>(missed), worst_late_ns / 1e6);
+}
 
-    // Write into framebuffer at top-left
+// Write overlay text into the framebuffer at top-left
+inline void Draw(Frame& fb, const OverlayLines& lines) {
     for (size_t i = 0; i < lines.size(); ++i) {
-        if (i >= static_cast<size_t>(CameraSettings::screen_height)) break;
-        const std::string& line = lines[i];
-        for (size_t x = 0; x < line.size() && x < CameraSettings::screen_width; ++x)
+        if (i >= static_cast<size_t>(fb.height())) break;
+        const std::pmr::string& line = lines[i];
+        for (size_t x = 0; x < line.size() && x < static_cast<size_t>(fb.width()); ++x)
             fb[i][x] = line[x];
     }
 }
 
+// Update and draw debug info
+inline void Draw(
+    Frame& fb,
+    const Vec3_t& camera_pos,
+    const Vec3_t& target,
+    double fps,
+    size_t present_bytes = 0) {
+    Draw(fb, Lines(camera_pos, target, fps, present_bytes));
+}
+
 } // namespace DebugUI
@@ -1,3 +1,5 @@
+#pragma once
+
 inline constexpr int MAX_X_COORDINATE = 10000;
 inline constexpr int MAX_Y_COORDINATE = 10000;
-inline constexpr int MAX_Z_COORDINATE = 10000;
\ No newline at end of file
+inline constexpr int MAX_Z_COORDINATE = 10000;
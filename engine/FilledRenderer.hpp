@@ -2,94 +2,575 @@
 #include "DataTypes.hpp"
 #include "CameraMath.hpp"
 #include "CameraSettings.hpp"
+#include "Clipping.hpp"
+#include "FrameProfiler.hpp"
+#include "Shading.hpp"
+#include "TransformStage.hpp"
+#include "Surface.hpp"
 
-// Draw a single triangle using barycentric fill and z-buffering
-inline void DrawFilledTriangle(Int2_t p0, Int2_t p1, Int2_t p2,
-    double z0, double z1, double z2,
-    char (&fb)[CameraSettings::screen_height][CameraSettings::screen_width],
-    double (&zbuf)[CameraSettings::screen_height][CameraSettings::screen_width],
-    char ch = '#') {
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+// ─────────────────────────────────────────────
+// Half-space triangle rasterizer
+// ─────────────────────────────────────────────
+//
+// Vertices are snapped to fixed point (1/16 pixel) and each edge becomes an
+// integer function E(x, y) = a*x + b*y + c evaluated at pixel sample points,
+// stepped incrementally across rows. Coverage follows the top-left fill rule,
+// so triangles sharing an edge never both write the same pixel. Depth is
+// interpolated as 1/z, which is affine in screen space.
+//
+// The bounding box is walked in RASTER_BLOCK x RASTER_BLOCK blocks aligned
+// to the depth pyramid's tiles: a block fully outside one edge is skipped,
+// and a block fully inside all three edges is filled without per-pixel edge
+// tests. Before any of that, a triangle behind the furthest depth of every
+// tile it touches is rejected (see DepthSurface).
+//
+// Everything that writes depth is a template over the depth buffer's
+// storage format; DepthBuffer is the build's default.
+//
+// A set-up triangle carries its own glyph, or for Gouraud shading a
+// luminance plane and the glyph table to read it through (see Shading.hpp).
+
+constexpr int RASTER_SUBPIXEL_BITS = 4;
+constexpr int RASTER_SUBPIXEL_ONE = 1 << RASTER_SUBPIXEL_BITS;
+constexpr int RASTER_BLOCK = 8;
+static_assert(RASTER_BLOCK == DepthBuffer::HIZ_TILE, "raster blocks are depth pyramid tiles");
+
+// Vertices further than this (in pixels) from the screen are clamped before
+// snapping so the 64-bit edge setup cannot overflow. Mesh triangles never
+// reach it: they are clipped to the guard band first.
+constexpr double RASTER_MAX_COORD = 65536.0;
+
+// Mesh triangles that stay within this many pixels of the screen are set up
+// unclipped (the rasterizer only walks the on-screen part of their bounds);
+// only triangles reaching past it are clipped.
+constexpr double RASTER_GUARD_BAND = 4096.0;
+
+struct TriangleSetup_t {
+    int64_t a[3], b[3], c[3];  // edge functions, top-left bias folded into c
+    double za, zb, zc;         // 1/z plane: inv_z = za * x + zb * y + zc
+    double la, lb, lc;         // luminance plane, only used with `ramp`
+    double z_near;             // nearest vertex depth
+    int minX, maxX, minY, maxY; // covered pixel bounds (unclipped)
+    char glyph;                // written to every covered pixel, unless...
+    const char* ramp;          // ...set: per-pixel glyph ramp[luminance]
+};
+
+// Snap a screen-space triangle and build its edge and depth planes. Returns
+// false for degenerate (zero-area) triangles. Either winding is accepted.
+// The glyph is '#' until the caller says otherwise.
+inline bool SetupTriangle(Vec2_t p0, Vec2_t p1, Vec2_t p2,
+                          double z0, double z1, double z2,
+                          TriangleSetup_t& t) {
+    auto snap = [](double v) -> int64_t {
+        v = std::clamp(v, -RASTER_MAX_COORD, RASTER_MAX_COORD);
+        return std::llround(v * RASTER_SUBPIXEL_ONE);
+    };
+    int64_t x[3] = {snap(p0.x), snap(p1.x), snap(p2.x)};
+    int64_t y[3] = {snap(p0.y), snap(p1.y), snap(p2.y)};
+    double w[3] = {1.0 / z0, 1.0 / z1, 1.0 / z2};
+    t.z_near = std::min({z0, z1, z2});
+    t.glyph = '#';
+    t.ramp = nullptr;
+
+    int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if (area == 0) return false;
+    if (area < 0) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(w[1], w[2]);
+        area = -area;
+    }
+
+    double za = 0.0, zb = 0.0, zc = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        // Edge opposite vertex i, from va to vb
+        const int va = (i + 1) % 3, vb = (i + 2) % 3;
+        const int64_t dx = x[vb] - x[va];
+        const int64_t dy = y[vb] - y[va];
+
+        // E(P) = dx * (P.y - y[va]) - dy * (P.x - x[va]) with P = pixel * ONE
+        t.a[i] = -dy * RASTER_SUBPIXEL_ONE;
+        t.b[i] = dx * RASTER_SUBPIXEL_ONE;
+        t.c[i] = dy * x[va] - dx * y[va];
 
-    int minX = std::min({p0.x, p1.x, p2.x});
-    int maxX = std::max({p0.x, p1.x, p2.x});
-    int minY = std::min({p0.y, p1.y, p2.y});
-    int maxY = std::max({p0.y, p1.y, p2.y});
+        za += static_cast<double>(t.a[i]) * w[i];
+        zb += static_cast<double>(t.b[i]) * w[i];
+        zc += static_cast<double>(t.c[i]) * w[i];
 
-    minX = std::clamp(minX, 0, CameraSettings::screen_width - 1);
-    maxX = std::clamp(maxX, 0, CameraSettings::screen_width - 1);
-    minY = std::clamp(minY, 0, CameraSettings::screen_height - 1);
-    maxY = std::clamp(maxY, 0, CameraSettings::screen_height - 1);
+        // Top-left rule (y grows downward): only top and left edges own
+        // the pixels exactly on them.
+        const bool top_left = (dy == 0 && dx > 0) || dy < 0;
+        if (!top_left) t.c[i] -= 1;
+    }
+
+    const double inv_area = 1.0 / static_cast<double>(area);
+    t.za = za * inv_area;
+    t.zb = zb * inv_area;
+    t.zc = zc * inv_area;
 
-    auto edge = [](const Int2_t& a, const Int2_t& b, const Int2_t& c) -> int {
-        return (c.x - a.x) * (b.y - a.y) - (c.y - a.y) * (b.x - a.x);
+    const int64_t minFx = std::min({x[0], x[1], x[2]});
+    const int64_t maxFx = std::max({x[0], x[1], x[2]});
+    const int64_t minFy = std::min({y[0], y[1], y[2]});
+    const int64_t maxFy = std::max({y[0], y[1], y[2]});
+    t.minX = static_cast<int>((minFx + RASTER_SUBPIXEL_ONE - 1) >> RASTER_SUBPIXEL_BITS);
+    t.maxX = static_cast<int>(maxFx >> RASTER_SUBPIXEL_BITS);
+    t.minY = static_cast<int>((minFy + RASTER_SUBPIXEL_ONE - 1) >> RASTER_SUBPIXEL_BITS);
+    t.maxY = static_cast<int>(maxFy >> RASTER_SUBPIXEL_BITS);
+    return true;
+}
+
+// Rasterizer body, writing glyph(x, y) to each pixel that passes the depth
+// test; see RasterizeTriangle. Without `DepthTest`, every covered pixel is
+// written in submission order and the depth buffer is not touched.
+template <bool DepthTest, typename Format, typename Glyph>
+inline void RasterizeTriangleWith(const TriangleSetup_t& t,
+    int clipX0, int clipY0, int clipX1, int clipY1,
+    Frame& fb,
+    DepthSurface<Format>& zbuf,
+    Glyph&& glyph) {
+
+    const int minX = std::max(t.minX, clipX0);
+    const int maxX = std::min(t.maxX, clipX1);
+    const int minY = std::max(t.minY, clipY0);
+    const int maxY = std::min(t.maxY, clipY1);
+    if (minX > maxX || minY > maxY) return;
+
+    // Nothing the triangle writes is nearer than z_near
+    const double z_near = Format::Nearer(t.z_near);
+    if constexpr (DepthTest)
+        if (zbuf.Occluded(minX, minY, maxX, maxY, z_near)) return;
+
+    auto shade = [&](int x, int y) {
+        if constexpr (DepthTest) {
+            const double inv_z = t.za * x + t.zb * y + t.zc;
+            if (Format::Passes(inv_z, zbuf[y][x])) { // z < zbuf without the divide
+                fb[y][x] = glyph(x, y);
+                zbuf[y][x] = Format::Store(1.0 / inv_z);
+            }
+        } else {
+            fb[y][x] = glyph(x, y);
+        }
     };
 
-    int area = edge(p0, p1, p2);
-    if (area == 0) return;
+    for (int ty = minY / RASTER_BLOCK; ty * RASTER_BLOCK <= maxY; ++ty) {
+        const int by0 = std::max(ty * RASTER_BLOCK, minY);
+        const int by1 = std::min(ty * RASTER_BLOCK + RASTER_BLOCK - 1, maxY);
+        for (int tx = minX / RASTER_BLOCK; tx * RASTER_BLOCK <= maxX; ++tx) {
+            const int bx0 = std::max(tx * RASTER_BLOCK, minX);
+            const int bx1 = std::min(tx * RASTER_BLOCK + RASTER_BLOCK - 1, maxX);
+            if constexpr (DepthTest)
+                if (z_near >= zbuf.tile_max(tx, ty)) continue; // hidden in this tile
 
-    double denom = static_cast<double>(area);
+            // Classify the block by each edge's extremes over its corners
+            bool outside = false, inside = true;
+            for (int i = 0; i < 3; ++i) {
+                const int64_t lo = t.c[i] + t.a[i] * (t.a[i] > 0 ? bx0 : bx1)
+                                          + t.b[i] * (t.b[i] > 0 ? by0 : by1);
+                const int64_t hi = t.c[i] + t.a[i] * (t.a[i] > 0 ? bx1 : bx0)
+                                          + t.b[i] * (t.b[i] > 0 ? by1 : by0);
+                if (hi < 0) { outside = true; break; }
+                if (lo < 0) inside = false;
+            }
+            if (outside) continue;
+            if constexpr (DepthTest) zbuf.Prepare(tx, ty);
 
-    for (int y = minY; y <= maxY; ++y) {
-        for (int x = minX; x <= maxX; ++x) {
-            Int2_t p = {x, y};
-            int w0 = edge(p1, p2, p);
-            int w1 = edge(p2, p0, p);
-            int w2 = edge(p0, p1, p);
+            if (inside && !DepthTest) {
+                for (int y = by0; y <= by1; ++y)
+                    for (int x = bx0; x <= bx1; ++x)
+                        shade(x, y);
+                continue;
+            }
+            if (inside) {
+                // 1/z is affine, so its extremes over the block are at corners
+                const double i00 = t.za * bx0 + t.zb * by0 + t.zc;
+                const double i10 = t.za * bx1 + t.zb * by0 + t.zc;
+                const double i01 = t.za * bx0 + t.zb * by1 + t.zc;
+                const double i11 = t.za * bx1 + t.zb * by1 + t.zc;
+                const double block_near = Format::Nearer(1.0 / std::max({i00, i10, i01, i11}));
+                const double block_far = Format::Further(1.0 / std::min({i00, i10, i01, i11}));
 
-            if ((w0 >= 0 && w1 >= 0 && w2 >= 0) || (w0 <= 0 && w1 <= 0 && w2 <= 0)) {
-                double alpha = w0 / denom;
-                double beta  = w1 / denom;
-                double gamma = w2 / denom;
+                if (block_far < zbuf.tile_min(tx, ty)) {
+                    // In front of everything in the tile: no depth test
+                    for (int y = by0; y <= by1; ++y)
+                        for (int x = bx0; x <= bx1; ++x) {
+                            fb[y][x] = glyph(x, y);
+                            zbuf[y][x] = Format::Store(1.0 / (t.za * x + t.zb * y + t.zc));
+                        }
+                } else {
+                    for (int y = by0; y <= by1; ++y)
+                        for (int x = bx0; x <= bx1; ++x)
+                            shade(x, y);
+                }
+                zbuf.NoteWrite(tx, ty, block_near);
 
-                double z = alpha * z0 + beta * z1 + gamma * z2;
+                int tile_x0, tile_y0, tile_x1, tile_y1;
+                zbuf.TileBounds(tx, ty, tile_x0, tile_y0, tile_x1, tile_y1);
+                if (bx0 == tile_x0 && bx1 == tile_x1 && by0 == tile_y0 && by1 == tile_y1)
+                    zbuf.CoverTile(tx, ty, block_far);
+                continue;
+            }
 
-                if (z < zbuf[y][x]) {
-                    fb[y][x] = ch;
-                    zbuf[y][x] = z;
+            int64_t row0 = t.a[0] * bx0 + t.b[0] * by0 + t.c[0];
+            int64_t row1 = t.a[1] * bx0 + t.b[1] * by0 + t.c[1];
+            int64_t row2 = t.a[2] * bx0 + t.b[2] * by0 + t.c[2];
+            for (int y = by0; y <= by1; ++y) {
+                int64_t e0 = row0, e1 = row1, e2 = row2;
+                for (int x = bx0; x <= bx1; ++x) {
+                    if ((e0 | e1 | e2) >= 0) shade(x, y);
+                    e0 += t.a[0]; e1 += t.a[1]; e2 += t.a[2];
                 }
+                row0 += t.b[0]; row1 += t.b[1]; row2 += t.b[2];
             }
+            if constexpr (DepthTest) zbuf.NoteWrite(tx, ty, z_near);
         }
     }
 }
 
-inline void RenderMeshFilled(const Vec3Buffer& verts,
-                             const TriangleBuffer& tris,
-                             const Vec3_t& eye,
-                             const Vec3_t& target,
-                             char (&fb)[CameraSettings::screen_height][CameraSettings::screen_width],
-                             double (&zbuf)[CameraSettings::screen_height][CameraSettings::screen_width],
-                             char fillChar = '#') {
-
-    auto view = LookAt(eye, target, CAMERA_UP);
-    const double focal = CameraSettings::FovToFocalLength(CameraSettings::camera_fov);
-
-    for (const auto& tri : tris.indices) {
-        Vec3Buffer cam;
-        WorldToCamera(verts, tri[0], view, eye, cam);
-        WorldToCamera(verts, tri[1], view, eye, cam);
-        WorldToCamera(verts, tri[2], view, eye, cam);
-
-        // Cull if any vertex is behind the camera
-        if (cam.z[0] <= 0 || cam.z[1] <= 0 || cam.z[2] <= 0) continue;
-
-        // Backface culling
-        Vec3_t v0 = {cam.x[0], cam.y[0], cam.z[0]};
-        Vec3_t v1 = {cam.x[1], cam.y[1], cam.z[1]};
-        Vec3_t v2 = {cam.x[2], cam.y[2], cam.z[2]};
-        Vec3_t e1 = VecSubAtomic(v1, v0);
-        Vec3_t e2 = VecSubAtomic(v2, v0);
+// Rasterize a set-up triangle, restricted to the inclusive pixel rectangle
+// [clipX0, clipX1] x [clipY0, clipY1]. Every pixel's coverage, depth and
+// glyph are computed from its absolute position, so the result does not
+// depend on the clip rectangle a triangle is split across.
+template <bool DepthTest = true, typename Format>
+inline void RasterizeTriangle(const TriangleSetup_t& t,
+    int clipX0, int clipY0, int clipX1, int clipY1,
+    Frame& fb,
+    DepthSurface<Format>& zbuf) {
+    if (t.ramp) {
+        RasterizeTriangleWith<DepthTest>(t, clipX0, clipY0, clipX1, clipY1, fb, zbuf, [&](int x, int y) {
+            return t.ramp[std::clamp(static_cast<int>(t.la * x + t.lb * y + t.lc), 0, 255)];
+        });
+    } else {
+        const char ch = t.glyph;
+        RasterizeTriangleWith<DepthTest>(t, clipX0, clipY0, clipX1, clipY1, fb, zbuf,
+                                         [ch](int, int) { return ch; });
+    }
+}
+
+// Draw a single triangle from subpixel screen positions and camera depths
+template <typename Format>
+inline void DrawFilledTriangle(Vec2_t p0, Vec2_t p1, Vec2_t p2,
+    double z0, double z1, double z2,
+    Frame& fb,
+    DepthSurface<Format>& zbuf,
+    char ch = '#') {
+    TriangleSetup_t t;
+    if (!SetupTriangle(p0, p1, p2, z0, z1, z2, t)) return;
+    t.glyph = ch;
+    RasterizeTriangle(t, 0, 0, fb.width() - 1, fb.height() - 1, fb, zbuf);
+}
+
+// Integer-pixel convenience overload
+template <typename Format>
+inline void DrawFilledTriangle(Int2_t p0, Int2_t p1, Int2_t p2,
+    double z0, double z1, double z2,
+    Frame& fb,
+    DepthSurface<Format>& zbuf,
+    char ch = '#') {
+    DrawFilledTriangle(Vec2_t{double(p0.x), double(p0.y)},
+                       Vec2_t{double(p1.x), double(p1.y)},
+                       Vec2_t{double(p2.x), double(p2.y)},
+                       z0, z1, z2, fb, zbuf, ch);
+}
+
+// A clipped triangle is set up as a fan over the clipped polygon
+constexpr size_t MAX_CLIPPED_TRIANGLES = MAX_CLIP_VERTICES - 2;
+
+// How the fill pass writes mesh triangles. Converts from a plain fill
+// character, which is what unshaded callers pass.
+//
+// Flat and Gouraud read per-vertex luminance from the vertex cache's
+// `light` lane (see Shading.hpp) and fall back to `fill` while it is empty.
+// With `facing` (one flag per triangle of the pass, from FacingMask), the
+// cached face planes decide culling and the per-triangle test is skipped.
+struct FillStyle {
+    char fill = '#';
+    ShadeMode mode = ShadeMode::Solid;
+    const GlyphRamp* ramp = nullptr;
+    std::span<const uint8_t> facing;
+    bool cull = true;       // drop back faces
+    bool depth_test = true; // false: painter's order, depth buffer untouched
+
+    FillStyle(char fill_char = '#') : fill(fill_char) {}
+};
+
+// The decisions a FillStyle makes, as a compile-time parameter: each fill
+// pass picks its variant once (WithFillFeatures) and runs a loop with the
+// rest folded away
+struct FillFeatures {
+    bool cull = true;
+    bool cached_cull = false; // cull from `facing` rather than per triangle
+    bool depth_test = true;
+    ShadeMode shade = ShadeMode::Solid;
+
+    bool operator==(const FillFeatures&) const = default;
+};
+
+// Features for a pass of `style` over `xf`; shading without a ramp or
+// vertex light is solid
+inline FillFeatures FillFeaturesOf(const FillStyle& style, const TransformedVertices& xf) {
+    FillFeatures f;
+    f.cull = style.cull;
+    f.cached_cull = style.cull && !style.facing.empty();
+    f.depth_test = style.depth_test;
+    f.shade = style.ramp && !xf.light.empty() ? style.mode : ShadeMode::Solid;
+    return f;
+}
+
+// Every FillFeatures FillFeaturesOf can return
+inline constexpr auto FILL_VARIANTS = [] {
+    std::array<FillFeatures, 18> variants{};
+    size_t n = 0;
+    for (int cull = 0; cull < 3; ++cull)  // off, per triangle, cached
+        for (bool depth_test : {false, true})
+            for (ShadeMode shade : {ShadeMode::Solid, ShadeMode::Flat, ShadeMode::Gouraud})
+                variants[n++] = {cull != 0, cull == 2, depth_test, shade};
+    return variants;
+}();
+
+// Calls fn.template operator()<F>() for the variant F equal to `features`
+template <typename Fn, size_t... I>
+inline void WithFillFeatures(const FillFeatures& features, Fn&& fn, std::index_sequence<I...>) {
+    (void)((features == FILL_VARIANTS[I] && (fn.template operator()<FILL_VARIANTS[I]>(), true)) || ...);
+}
+
+template <typename Fn>
+inline void WithFillFeatures(const FillFeatures& features, Fn&& fn) {
+    WithFillFeatures(features, fn, std::make_index_sequence<FILL_VARIANTS.size()>());
+}
+
+// Luminance plane through three screen points, 0.5 biased so truncating
+// it rounds
+inline void SetupLuminancePlane(const ClipVertex_t* p, const double* l, TriangleSetup_t& t) {
+    const double dx1 = p[1].x - p[0].x, dy1 = p[1].y - p[0].y, dl1 = l[1] - l[0];
+    const double dx2 = p[2].x - p[0].x, dy2 = p[2].y - p[0].y, dl2 = l[2] - l[0];
+    const double det = dx1 * dy2 - dx2 * dy1;
+    t.la = (dl1 * dy2 - dl2 * dy1) / det;
+    t.lb = (dx1 * dl2 - dx2 * dl1) / det;
+    t.lc = l[0] + 0.5 - t.la * p[0].x - t.lb * p[0].y;
+}
+
+// Cull, clip and set up one mesh triangle from the post-transform cache into
+// `out` (room for MAX_CLIPPED_TRIANGLES). Returns the number of setups;
+// zero if the triangle is back-facing, behind the near plane, off screen or
+// degenerate. `F` must be FillFeaturesOf(style, xf); with cached culling
+// the caller has already dropped back faces.
+//
+// Triangles crossing the near plane are clipped in camera space. Triangles
+// entirely beyond one screen edge (or one edge of `area`, when given) are
+// rejected before setup, and only those reaching past the guard band are
+// clipped in screen space.
+template <FillFeatures F, typename Index>
+inline size_t SetupMeshTriangle(const TransformedVertices& xf,
+                                const std::array<Index, 3>& tri,
+                                int screen_width, int screen_height,
+                                TriangleSetup_t* out,
+                                const FillStyle& style,
+                                const PixelRect_t* area = nullptr) {
+    const size_t index[3] = {tri[0], tri[1], tri[2]};
+    Vec3_t v[3];
+    for (int k = 0; k < 3; ++k)
+        v[k] = {xf.cam.x()[index[k]], xf.cam.y()[index[k]], xf.cam.z()[index[k]]};
+
+    // Backface culling (valid on either side of the eye)
+    if constexpr (F.cull && !F.cached_cull) {
+        Vec3_t e1 = VecSubAtomic(v[1], v[0]);
+        Vec3_t e2 = VecSubAtomic(v[2], v[0]);
         Vec3_t normal = VecCrossAtomic(e1, e2);
-        if (VecDotAtomic(normal, v0) >= 0.0) continue;
+        if (VecDotAtomic(normal, v[0]) >= 0.0) return 0;
+    }
+
+    const double near = CameraSettings::near_plane;
+    const int in_front = (v[0].z >= near) + (v[1].z >= near) + (v[2].z >= near);
+    if (in_front == 0) return 0;
+
+    ClipVertex_t poly[MAX_CLIP_VERTICES];
+    size_t n = 0;
+    if (in_front == 3) {
+        for (int k = 0; k < 3; ++k) {
+            const Vec2_t p = MapToScreenSubpixel(xf.proj, index[k], screen_width, screen_height);
+            poly[n++] = {p.x, p.y, v[k].z};
+        }
+    } else {
+        Vec3_t clipped[4];
+        const size_t m = ClipPolygonNear(v, 3, near, clipped);
+        for (size_t k = 0; k < m; ++k) {
+            const Vec2_t p = xf.ProjectSubpixel(clipped[k], screen_width, screen_height);
+            poly[n++] = {p.x, p.y, clipped[k].z};
+        }
+    }
+
+    // One pixel of margin so snapping cannot pull a rejected triangle onto
+    // a pixel center
+    const ClipRect_t screen = area
+        ? ClipRect_t{area->x0 - 1.0, area->y0 - 1.0, area->x1 + 1.0, area->y1 + 1.0}
+        : ClipRect_t{-1.0, -1.0, double(screen_width), double(screen_height)};
+    const ClipRect_t guard = {-RASTER_GUARD_BAND, -RASTER_GUARD_BAND,
+                              screen_width + RASTER_GUARD_BAND,
+                              screen_height + RASTER_GUARD_BAND};
+    uint8_t off_screen = 0xFF, past_guard = 0;
+    for (size_t k = 0; k < n; ++k) {
+        off_screen &= Outcode(poly[k].x, poly[k].y, screen);
+        past_guard |= Outcode(poly[k].x, poly[k].y, guard);
+    }
+    if (off_screen) return 0;
+
+    // Gouraud needs the original corners on screen; a triangle clipped at
+    // the near plane is shaded flat instead
+    char glyph = style.fill;
+    const char* ramp = nullptr;
+    double lum[3] = {};
+    if constexpr (F.shade != ShadeMode::Solid) {
+        for (int k = 0; k < 3; ++k) lum[k] = xf.light[index[k]];
+        if (F.shade == ShadeMode::Gouraud && in_front == 3)
+            ramp = style.ramp->data();
+        else
+            glyph = (*style.ramp)[static_cast<uint8_t>((lum[0] + lum[1] + lum[2]) / 3.0 + 0.5)];
+    }
+    ClipVertex_t corners[3] = {};
+    if (ramp) std::copy(poly, poly + 3, corners);
 
-        Vec2Buffer proj;
-        ProjectToScreen(cam, 0, focal, CameraSettings::aspect_ratio, proj);
-        ProjectToScreen(cam, 1, focal, CameraSettings::aspect_ratio, proj);
-        ProjectToScreen(cam, 2, focal, CameraSettings::aspect_ratio, proj);
+    if (past_guard) n = ClipPolygonRect(poly, n, guard);
 
-        Int2_t p0 = MapToScreen(proj, 0, CameraSettings::screen_width, CameraSettings::screen_height);
-        Int2_t p1 = MapToScreen(proj, 1, CameraSettings::screen_width, CameraSettings::screen_height);
-        Int2_t p2 = MapToScreen(proj, 2, CameraSettings::screen_width, CameraSettings::screen_height);
+    size_t count = 0;
+    for (size_t k = 1; k + 1 < n; ++k)
+        if (SetupTriangle({poly[0].x, poly[0].y}, {poly[k].x, poly[k].y},
+                          {poly[k + 1].x, poly[k + 1].y},
+                          poly[0].z, poly[k].z, poly[k + 1].z, out[count])) {
+            out[count].glyph = glyph;
+            out[count].ramp = ramp;
+            if (ramp) SetupLuminancePlane(corners, lum, out[count]);
+            ++count;
+        }
+    return count;
+}
+
+// Triangles are culled/set up and rasterized in batches of this many, so the
+// two phases can be timed separately without a clock read per triangle
+constexpr size_t FILL_SETUP_BATCH = 128;
 
-        DrawFilledTriangle(p0, p1, p2, cam.z[0], cam.z[1], cam.z[2], fb, zbuf, fillChar);
+// Front-to-back submission order for the fill pass: triangles sorted by
+// their nearest vertex depth, so near geometry tightens the depth pyramid
+// before the triangles it hides reach the rasterizer. Keep it alive across
+// frames; Update() once per frame after the transform stage.
+struct FillOrder {
+    std::vector<uint32_t> order;
+
+    template <typename Index>
+    void Update(const TransformedVertices& xf, std::span<const std::array<Index, 3>> tris) {
+        // Non-negative floats order like their bit patterns; the triangle
+        // index in the low half keeps the sort stable
+        keys_.resize(tris.size());
+        for (size_t t = 0; t < tris.size(); ++t) {
+            const auto& tri = tris[t];
+            const float z = static_cast<float>(std::max(
+                0.0, std::min({xf.cam.z()[tri[0]], xf.cam.z()[tri[1]], xf.cam.z()[tri[2]]})));
+            keys_[t] = static_cast<uint64_t>(std::bit_cast<uint32_t>(z)) << 32 | t;
+        }
+        std::sort(keys_.begin(), keys_.end());
+        order.resize(tris.size());
+        for (size_t t = 0; t < tris.size(); ++t)
+            order[t] = static_cast<uint32_t>(keys_[t]);
+    }
+
+    template <typename Index>
+    void Update(const TransformedVertices& xf, const TriangleList<Index>& tris) {
+        Update(xf, std::span<const std::array<Index, 3>>(tris.indices));
+    }
+
+private:
+    std::vector<uint64_t> keys_;
+};
+
+// Fill pass over a pre-transformed vertex cache (see TransformStage.hpp).
+// Triangles are drawn in `order` (indices into `tris`) when it is not empty.
+// Only pixels inside `scissor` (which must lie inside the surface) are
+// written, exactly as a full pass would write them. `style.facing`, when
+// set, is indexed like `tris`.
+//
+// FillTrianglesWith is the pass for one FillFeatures variant; FillTriangles
+// picks it from `style`.
+template <FillFeatures F, typename Index, typename Format>
+inline void FillTrianglesWith(const TransformedVertices& xf,
+                              std::span<const std::array<Index, 3>> tris,
+                              Frame& fb,
+                              DepthSurface<Format>& zbuf,
+                              const PixelRect_t& scissor,
+                              const FillStyle& style,
+                              std::span<const uint32_t> order = {}) {
+    if (scissor.empty()) return;
+    const bool partial = scissor != fb.bounds();
+    std::array<TriangleSetup_t, FILL_SETUP_BATCH + MAX_CLIPPED_TRIANGLES> setups;
+    const size_t count = tris.size();
+    for (size_t i = 0; i < count;) {
+        size_t ready = 0;
+        {
+            PROFILE_SCOPE(Cull);
+            for (; i < count && ready < FILL_SETUP_BATCH; ++i) {
+                const size_t t = order.empty() ? i : order[i];
+                if constexpr (F.cached_cull)
+                    if (!style.facing[t]) continue;
+                ready += SetupMeshTriangle<F>(xf, tris[t], fb.width(), fb.height(), &setups[ready],
+                                              style, partial ? &scissor : nullptr);
+            }
+        }
+        PROFILE_SCOPE(Raster);
+        for (size_t k = 0; k < ready; ++k)
+            RasterizeTriangle<F.depth_test>(setups[k], scissor.x0, scissor.y0, scissor.x1, scissor.y1,
+                                             fb, zbuf);
     }
 }
+
+template <typename Index, typename Format>
+inline void FillTriangles(const TransformedVertices& xf,
+                          std::span<const std::array<Index, 3>> tris,
+                          Frame& fb,
+                          DepthSurface<Format>& zbuf,
+                          const PixelRect_t& scissor,
+                          const FillStyle& style = {},
+                          std::span<const uint32_t> order = {}) {
+    WithFillFeatures(FillFeaturesOf(style, xf), [&]<FillFeatures F>() {
+        FillTrianglesWith<F>(xf, tris, fb, zbuf, scissor, style, order);
+    });
+}
+
+template <typename Index, typename Format>
+inline void FillTriangles(const TransformedVertices& xf,
+                          std::span<const std::array<Index, 3>> tris,
+                          Frame& fb,
+                          DepthSurface<Format>& zbuf,
+                          const FillStyle& style = {},
+                          std::span<const uint32_t> order = {}) {
+    FillTriangles(xf, tris, fb, zbuf, fb.bounds(), style, order);
+}
+
+template <typename Index, typename Format>
+inline void RenderMeshFilled(const TransformedVertices& xf,
+                             const TriangleList<Index>& tris,
+                             Frame& fb,
+                             DepthSurface<Format>& zbuf,
+                             const FillStyle& style = {},
+                             std::span<const uint32_t> order = {}) {
+    FillTriangles(xf, std::span<const std::array<Index, 3>>(tris.indices), fb, zbuf, style, order);
+}
+
+template <typename Positions, typename Index, typename Format>
+inline void RenderMeshFilled(const Positions& verts,
+                             const TriangleList<Index>& tris,
+                             const Vec3_t& eye,
+                             const Vec3_t& target,
+                             Frame& fb,
+                             DepthSurface<Format>& zbuf,
+                             const FillStyle& style = {}) {
+    TransformedVertices xf;
+    TransformVertices(verts, eye, target, xf, fb.aspect_ratio());
+    RenderMeshFilled(xf, tris, fb, zbuf, style);
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+
+// ─────────────────────────────────────────────
+// Per-frame arena
+// ─────────────────────────────────────────────
+//
+// Frame-lifetime temporaries (overlay text, scratch lists) are carved out
+// of one buffer by a monotonic std::pmr resource and all released at once
+// by Reset() at the top of the next frame. A frame that needs more than the
+// buffer spills to the heap; the next Reset() grows the buffer by what was
+// spilled, so after a few frames the loop stops touching the heap at all.
+// For the frame thread only: the resource is not thread-safe.
+
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity = 16 * 1024) { Allocate(capacity); }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    inline std::pmr::memory_resource* resource() { return &*arena_; }
+
+    // Releases everything allocated since the last Reset
+    inline void Reset() {
+        arena_->release();
+        if (spill_.bytes == 0) return;
+        const size_t grown = capacity_ + spill_.bytes;
+        arena_.reset();
+        Allocate(grown);
+    }
+
+    inline size_t capacity() const { return capacity_; }
+
+    // Bytes the current frame has taken from the heap so far
+    inline size_t spilled() const { return spill_.bytes; }
+
+private:
+    // Upstream of the arena: the heap, with the bytes it handed out counted
+    struct SpillCounter final : std::pmr::memory_resource {
+        size_t bytes = 0;
+
+        void* do_allocate(size_t n, size_t align) override {
+            bytes += n;
+            return std::pmr::new_delete_resource()->allocate(n, align);
+        }
+        void do_deallocate(void* p, size_t n, size_t align) override {
+            std::pmr::new_delete_resource()->deallocate(p, n, align);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    void Allocate(size_t capacity) {
+        capacity_ = capacity;
+        buffer_ = std::make_unique<std::byte[]>(capacity);
+        spill_.bytes = 0;
+        arena_.emplace(buffer_.get(), capacity, &spill_);
+    }
+
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t capacity_ = 0;
+    SpillCounter spill_;
+    std::optional<std::pmr::monotonic_buffer_resource> arena_;
+};
+
+// ─────────────────────────────────────────────
+// Global allocation counter
+// ─────────────────────────────────────────────
+//
+// Counts every global operator new, on any thread, so a frame loop can show
+// that it no longer allocates. Replacement operators must be defined exactly
+// once per program: put COUNT_GLOBAL_ALLOCATIONS() at namespace scope in the
+// translation unit holding main(). Without it the count stays at zero.
+
+namespace HeapStats {
+
+inline std::atomic<uint64_t> allocations{0};
+inline bool counting = false;
+
+inline uint64_t Allocations() { return allocations.load(std::memory_order_relaxed); }
+
+// Out of memory in a throwing new: bad_alloc, or abort where exceptions
+// are compiled out (make small)
+[[noreturn]] inline void OutOfMemory() {
+#if __cpp_exceptions
+    throw std::bad_alloc();
+#else
+    std::abort();
+#endif
+}
+
+// Counted malloc / aligned_alloc: nullptr when out of memory, as the
+// nothrow forms of new return
+inline void* TryAlloc(size_t n) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(n ? n : 1);
+}
+
+inline void* TryAlignedAlloc(size_t n, std::align_val_t align) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const size_t a = static_cast<size_t>(align);
+    return std::aligned_alloc(a, n ? (n + a - 1) / a * a : a);
+}
+
+// Every replaced delete frees through here. Kept out of line so the
+// compiler never sees a new-expression's pointer reach free() and warns
+// about a mismatch (-Wmismatched-new-delete) that is in fact paired.
+[[gnu::noinline]] inline void Free(void* p) noexcept { std::free(p); }
+
+inline void* CountedAlloc(size_t n) {
+    if (void* p = TryAlloc(n)) return p;
+    OutOfMemory();
+}
+
+inline void* CountedAlignedAlloc(size_t n, std::align_val_t align) {
+    if (void* p = TryAlignedAlloc(n, align)) return p;
+    OutOfMemory();
+}
+
+} // namespace HeapStats
+
+// Every new and delete form is defined, nothrow ones included, so no
+// allocation can come from one allocator (a sanitizer's, say) and be freed
+// by another
+#define COUNT_GLOBAL_ALLOCATIONS()                                                              \
+    void* operator new(std::size_t n) { return HeapStats::CountedAlloc(n); }                    \
+    void* operator new[](std::size_t n) { return HeapStats::CountedAlloc(n); }                  \
+    void* operator new(std::size_t n, std::align_val_t a) {                                     \
+        return HeapStats::CountedAlignedAlloc(n, a);                                            \
+    }                                                                                           \
+    void* operator new[](std::size_t n, std::align_val_t a) {                                   \
+        return HeapStats::CountedAlignedAlloc(n, a);                                            \
+    }                                                                                           \
+    void* operator new(std::size_t n, const std::nothrow_t&) noexcept {                         \
+        return HeapStats::TryAlloc(n);                                                          \
+    }                                                                                           \
+    void* operator new[](std::size_t n, const std::nothrow_t&) noexcept {                       \
+        return HeapStats::TryAlloc(n);                                                          \
+    }                                                                                           \
+    void* operator new(std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept {     \
+        return HeapStats::TryAlignedAlloc(n, a);                                                \
+    }                                                                                           \
+    void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept {   \
+        return HeapStats::TryAlignedAlloc(n, a);                                                \
+    }                                                                                           \
+    void operator delete(void* p) noexcept { HeapStats::Free(p); }                              \
+    void operator delete[](void* p) noexcept { HeapStats::Free(p); }                            \
+    void operator delete(void* p, std::size_t) noexcept { HeapStats::Free(p); }                 \
+    void operator delete[](void* p, std::size_t) noexcept { HeapStats::Free(p); }               \
+    void operator delete(void* p, std::align_val_t) noexcept { HeapStats::Free(p); }            \
+    void operator delete[](void* p, std::align_val_t) noexcept { HeapStats::Free(p); }          \
+    void operator delete(void* p, std::size_t, std::align_val_t) noexcept {                     \
+        HeapStats::Free(p);                                                                     \
+    }                                                                                           \
+    void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {                   \
+        HeapStats::Free(p);                                                                     \
+    }                                                                                           \
+    void operator delete(void* p, const std::nothrow_t&) noexcept { HeapStats::Free(p); }       \
+    void operator delete[](void* p, const std::nothrow_t&) noexcept { HeapStats::Free(p); }     \
+    void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {           \
+        HeapStats::Free(p);                                                                     \
+    }                                                                                           \
+    void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {         \
+        HeapStats::Free(p);                                                                     \
+    }                                                                                           \
+    [[maybe_unused]] static const bool heap_stats_counting_ = (HeapStats::counting = true)
@@ -1,35 +1,44 @@
 #pragma once
 #include "CameraSettings.hpp"
+#include "FrameProfiler.hpp"
+#include "Surface.hpp"
 #include <iostream>
 #include <cstring>
-
-using Frame = char[CameraSettings::screen_height][CameraSettings::screen_width];
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+#include <string>
 
 namespace FrameIO {
 
+using ::DepthBuffer;
+
 // ─────────────────────────────────────────────
 // Framebuffer operations
 // ─────────────────────────────────────────────
 
 inline void ClearFramebuffer(Frame& fb, char fill = ' ') {
-    for (int y = 0; y < CameraSettings::screen_height; ++y)
-        for (int x = 0; x < CameraSettings::screen_width; ++x)
-            fb[y][x] = fill;
+    fb.Fill(fill);
 }
 
 inline bool CompareBuffers(const Frame& a, const Frame& b) {
-    return std::memcmp(a, b, sizeof(Frame)) == 0;
+    if (a.width() != b.width() || a.height() != b.height()) return false;
+    for (int y = 0; y < a.height(); ++y)
+        if (std::memcmp(a[y], b[y], a.width()) != 0) return false;
+    return true;
 }
 
+// Resizes `dst` to match `src` if needed
 inline void CopyBuffer(Frame& dst, const Frame& src) {
-    std::memcpy(dst, src, sizeof(Frame));
+    dst.Resize(src.width(), src.height());
+    for (int y = 0; y < src.height(); ++y)
+        std::memcpy(dst[y], src[y], src.width());
 }
 
 inline void RenderFramebuffer(const Frame& fb) {
     std::cout << "\033[?25l\033[H"; // hide cursor + move to top-left
-    for (int y = 0; y < CameraSettings::screen_height; ++y) {
-        for (int x = 0; x < CameraSettings::screen_width; ++x)
-            std::cout << fb[y][x];
+    for (int y = 0; y < fb.height(); ++y) {
+        std::cout.write(fb[y], fb.width());
         std::cout << '\n';
     }
     std::cout << std::flush;
@@ -38,10 +47,10 @@ inline void RenderFramebuffer(const Frame& fb) {
 inline void RenderChangedLines(const Frame& current,
                                const Frame& previous) {
     std::cout << "\033[?25l"; // Hide cursor
-    for (int y = 0; y < CameraSettings::screen_height; ++y) {
-        if (std::memcmp(current[y], previous[y], CameraSettings::screen_width) != 0) {
+    for (int y = 0; y < current.height(); ++y) {
+        if (std::memcmp(current[y], previous[y], current.width()) != 0) {
             std::cout << "\033[" << (y + 1) << ";1H"; // move cursor to changed line
-            for (int x = 0; x < CameraSettings::screen_width; ++x)
+            for (int x = 0; x < current.width(); ++x)
                 std::cout << current[y][x];
         }
     }
@@ -49,29 +58,176 @@ inline void RenderChangedLines(const Frame& current,
 }
 
 // ─────────────────────────────────────────────
-// Depth buffer structure
+// Span-diffing presenter
 // ─────────────────────────────────────────────
+//
+// Diffs the new frame against the one on screen and encodes only the changed
+// runs of cells, each preceded by a cursor-move escape, into one reusable
+// byte buffer. Runs separated by fewer unchanged cells than a cursor move
+// costs are merged. The whole frame goes out in a single write(2), wrapped in
+// synchronized-update escapes (DEC mode 2026) so terminals that support it
+// swap the frame in atomically instead of tearing.
+
+class FramePresenter {
+public:
+    explicit FramePresenter(int fd = STDOUT_FILENO) : fd_(fd) {}
+
+    // Emit the cells of `current` that differ from `previous` (the frame
+    // currently on screen). A size mismatch redraws everything. Returns the
+    // number of bytes written; 0 if nothing changed.
+    size_t Present(const Frame& current, const Frame& previous) {
+        const bool full = current.width() != previous.width() ||
+                          current.height() != previous.height();
+        Begin();
+        for (int y = 0; y < current.height(); ++y) {
+            const char* cur = current[y];
+            if (full) {
+                EmitSpan(y, 0, cur, current.width());
+                continue;
+            }
+            const char* prev = previous[y];
+            if (std::memcmp(cur, prev, current.width()) == 0) continue;
+            EncodeRowDiff(y, cur, prev, current.width());
+        }
+        return Finish();
+    }
+
+    // Clear the terminal and home the cursor (one write)
+    void ClearScreen() {
+        out_.clear();
+        Append("\033[2J\033[H");
+        WriteAll();
+    }
+
+    // Clear the terminal and print `text` from the top left (one write)
+    void ShowMessage(const char* text) {
+        out_.clear();
+        Append("\033[2J\033[H");
+        Append(text);
+        WriteAll();
+    }
+
+    // Redraw every cell
+    size_t PresentFull(const Frame& current) {
+        Begin();
+        for (int y = 0; y < current.height(); ++y)
+            EmitSpan(y, 0, current[y], current.width());
+        return Finish();
+    }
+
+    inline size_t last_bytes() const { return last_bytes_; }
+    inline uint64_t total_bytes() const { return total_bytes_; }
+
+    // Time the last Present spent in write(2), as opposed to diffing/encoding
+    inline int64_t last_write_ns() const { return last_write_ns_; }
+
+    // Encoded bytes of the last frame (valid until the next Present)
+    inline const std::string& buffer() const { return out_; }
+
+    // A negative fd encodes without writing (benchmarks, headless runs)
+    inline void set_fd(int fd) { fd_ = fd; }
 
-struct DepthBuffer {
-    double values[CameraSettings::screen_height][CameraSettings::screen_width];
+private:
+    // Unchanged cells shorter than this are re-sent rather than skipped with
+    // a cursor move ("\033[R;CH" is 6-10 bytes)
+    static constexpr int MERGE_GAP = 8;
 
-    void clear(double far_z = CameraSettings::far_plane) {
-        for (int y = 0; y < CameraSettings::screen_height; ++y)
-            for (int x = 0; x < CameraSettings::screen_width; ++x)
-                values[y][x] = far_z;
+    void Begin() {
+        out_.clear();
+        payload_ = false;
+        Append("\033[?2026h\033[?25l");
     }
+
+    size_t Finish() {
+        if (!payload_) {
+            out_.clear();
+            last_bytes_ = 0;
+            last_write_ns_ = 0;
+            return 0;
+        }
+        Append("\033[?2026l");
+        const int64_t write_begin = Profiler::Now();
+        WriteAll();
+        last_write_ns_ = Profiler::Now() - write_begin;
+        last_bytes_ = out_.size();
+        total_bytes_ += out_.size();
+        return out_.size();
+    }
+
+    void EncodeRowDiff(int y, const char* cur, const char* prev, int width) {
+        int x = 0;
+        while (x < width) {
+            while (x < width && cur[x] == prev[x]) ++x;
+            if (x == width) break;
+            const int start = x;
+            int end = x;  // one past the last differing cell of the run
+            while (x < width) {
+                if (cur[x] != prev[x]) {
+                    end = ++x;
+                    continue;
+                }
+                int gap = x;
+                while (gap < width && cur[gap] == prev[gap] && gap - end < MERGE_GAP) ++gap;
+                if (gap < width && cur[gap] != prev[gap]) { x = gap; continue; }
+                break;
+            }
+            EmitSpan(y, start, cur + start, end - start);
+            x = end;
+        }
+    }
+
+    void EmitSpan(int y, int x, const char* cells, int count) {
+        Append("\033[");
+        AppendUInt(static_cast<unsigned>(y + 1));
+        out_.push_back(';');
+        AppendUInt(static_cast<unsigned>(x + 1));
+        out_.push_back('H');
+        out_.append(cells, static_cast<size_t>(count));
+        payload_ = true;
+    }
+
+    inline void Append(const char* s) { out_.append(s); }
+
+    void AppendUInt(unsigned v) {
+        char digits[10];
+        int n = 0;
+        do { digits[n++] = static_cast<char>('0' + v % 10); v /= 10; } while (v);
+        while (n) out_.push_back(digits[--n]);
+    }
+
+    // One write(2) in the common case; loops only on partial writes / EINTR
+    void WriteAll() {
+        if (fd_ < 0) return;
+        const char* p = out_.data();
+        size_t left = out_.size();
+        while (left > 0) {
+            ssize_t n = ::write(fd_, p, left);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+    }
+
+    int fd_;
+    std::string out_;
+    bool payload_ = false;
+    size_t last_bytes_ = 0;
+    uint64_t total_bytes_ = 0;
+    int64_t last_write_ns_ = 0;
 };
 
 // ─────────────────────────────────────────────
-// Optional C-style clear for raw z-buffer arrays
+// Depth buffer clear
 // ─────────────────────────────────────────────
 
-inline void ClearZBuffer(
-    double (&zbuf)[CameraSettings::screen_height][CameraSettings::screen_width],
-    double depth = CameraSettings::far_plane) {
-    for (int y = 0; y < CameraSettings::screen_height; ++y)
-        for (int x = 0; x < CameraSettings::screen_width; ++x)
-            zbuf[y][x] = depth;
+// Cheap: pixels are cleared a tile at a time as the rasterizer reaches them
+template <typename Format>
+inline void ClearZBuffer(DepthSurface<Format>& zbuf,
+                         double depth = CameraSettings::far_plane) {
+    zbuf.Fill(depth);
 }
 
 } // namespace FrameIO
@@ -0,0 +1,92 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+
+// ─────────────────────────────────────────────
+// Deadline-based frame pacing
+// ─────────────────────────────────────────────
+//
+// Frames are paced against absolute deadlines one period apart on
+// CLOCK_MONOTONIC, slept to with clock_nanosleep(TIMER_ABSTIME): however
+// long a frame's work took, the next one starts on the beat, and the
+// thread is asleep (not spinning) for the rest of the period. A frame that
+// overruns its deadline is counted as missed and the cadence restarts from
+// then, rather than rushing the following frames to catch up.
+//
+// Simulation runs on its own fixed tick: each frame, BeginFrame() returns
+// how many ticks of real time have passed, and alpha() how far into the
+// next tick the frame falls, for interpolating what is drawn. The sim thus
+// advances the same way at any frame rate.
+
+class FramePacer {
+public:
+    // Elapsed time beyond this is dropped rather than simulated (a stall,
+    // a debugger), so a long pause never turns into a burst of ticks
+    static constexpr int64_t MAX_CATCH_UP_NS = 250'000'000;
+
+    explicit FramePacer(double frame_hz = 60.0, double tick_hz = 120.0) {
+        SetRate(frame_hz);
+        SetTickRate(tick_hz);
+        last_ns_ = deadline_ns_ = Now();
+    }
+
+    inline void SetRate(double hz) { period_ns_ = PeriodNs(hz); }
+    inline void SetTickRate(double hz) { tick_ns_ = PeriodNs(hz); }
+
+    inline int64_t period_ns() const { return period_ns_; }
+    inline int64_t tick_ns() const { return tick_ns_; }
+    inline double tick_seconds() const { return tick_ns_ / 1e9; }
+
+    // Start of a frame: the number of simulation ticks to run
+    inline int BeginFrame() {
+        const int64_t now = Now();
+        accumulator_ns_ += std::min(now - last_ns_, MAX_CATCH_UP_NS);
+        last_ns_ = now;
+        const int64_t ticks = accumulator_ns_ / tick_ns_;
+        accumulator_ns_ -= ticks * tick_ns_;
+        return static_cast<int>(ticks);
+    }
+
+    // Fraction of a tick real time is ahead of the simulation, in [0, 1)
+    inline double alpha() const { return static_cast<double>(accumulator_ns_) / tick_ns_; }
+
+    // End of a frame: sleeps until its deadline
+    inline void Wait() {
+        deadline_ns_ += period_ns_;
+        const int64_t now = Now();
+        if (now > deadline_ns_) {
+            ++missed_;
+            worst_late_ns_ = std::max(worst_late_ns_, now - deadline_ns_);
+            deadline_ns_ = now;
+            return;
+        }
+        const timespec at = {static_cast<time_t>(deadline_ns_ / 1'000'000'000),
+                             static_cast<long>(deadline_ns_ % 1'000'000'000)};
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &at, nullptr) == EINTR) {}
+    }
+
+    inline uint64_t missed() const { return missed_; }
+    inline int64_t worst_late_ns() const { return worst_late_ns_; }
+
+    // Nanoseconds on the pacing clock
+    static int64_t Now() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+    }
+
+private:
+    static int64_t PeriodNs(double hz) {
+        return std::max<int64_t>(1, static_cast<int64_t>(1e9 / std::max(hz, 1e-3)));
+    }
+
+    int64_t period_ns_ = 0;
+    int64_t tick_ns_ = 0;
+    int64_t deadline_ns_ = 0;
+    int64_t last_ns_ = 0;
+    int64_t accumulator_ns_ = 0;
+    uint64_t missed_ = 0;
+    int64_t worst_late_ns_ = 0;
+};
@@ -0,0 +1,306 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+namespace Profiler {
+
+// ─────────────────────────────────────────────
+// Pipeline stages
+// ─────────────────────────────────────────────
+//
+// Stages form a fixed hierarchy: everything the frame thread does nests
+// under Frame, and Cull/Raster nest under Fill. Diff and Present run on the
+// presenter thread and are roots of their own.
+
+enum class Stage : uint8_t {
+    Frame,
+    Input,
+    Clear,
+    Transform,
+    Fill,
+    Cull,
+    Raster,
+    Edges,
+    Overlay,
+    Diff,
+    Present,
+    COUNT
+};
+
+inline constexpr size_t STAGE_COUNT = static_cast<size_t>(Stage::COUNT);
+inline constexpr int NO_PARENT = -1;
+
+struct StageInfo {
+    const char* name;
+    int parent;
+    int thread; // 0 = frame thread, 1 = presenter thread
+};
+
+inline constexpr int FRAME = static_cast<int>(Stage::Frame);
+inline constexpr int FILL = static_cast<int>(Stage::Fill);
+
+// Indexed by Stage; parents always precede their children
+inline constexpr std::array<StageInfo, STAGE_COUNT> STAGES = {{
+    {"Frame",     NO_PARENT, 0},
+    {"Input",     FRAME, 0},
+    {"Clear",     FRAME, 0},
+    {"Transform", FRAME, 0},
+    {"Fill",      FRAME, 0},
+    {"Cull",      FILL, 0},
+    {"Raster",    FILL, 0},
+    {"Edges",     FRAME, 0},
+    {"Overlay",   FRAME, 0},
+    {"Diff",      NO_PARENT, 1},
+    {"Present",   NO_PARENT, 1},
+}};
+
+inline constexpr int Depth(size_t s) {
+    int depth = 0;
+    for (int p = STAGES[s].parent; p != NO_PARENT; p = STAGES[p].parent) ++depth;
+    return depth;
+}
+
+inline constexpr bool IsLeaf(size_t s) {
+    for (const StageInfo& info : STAGES)
+        if (info.parent == static_cast<int>(s)) return false;
+    return true;
+}
+
+// ─────────────────────────────────────────────
+// Frame records
+// ─────────────────────────────────────────────
+//
+// One record per frame in a fixed ring; nothing allocates while recording.
+// A stage entered more than once in a frame (Cull/Raster run in batches)
+// keeps the time of its first entry and the sum of its durations.
+
+inline constexpr size_t TRACE_CAPACITY = 2048; // frames kept for the trace
+inline constexpr size_t STATS_WINDOW = 120;    // frames behind the p50/p99
+
+struct FrameRecord {
+    uint64_t frame = 0;
+    uint32_t entered = 0;                   // bit per stage
+    std::array<int64_t, STAGE_COUNT> begin_ns{};
+    std::array<int64_t, STAGE_COUNT> total_ns{};
+};
+
+struct StageStats {
+    int64_t p50_ns = 0;
+    int64_t p99_ns = 0;
+    size_t samples = 0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+inline const Clock::time_point epoch = Clock::now();
+
+// Nanoseconds since the profiler epoch
+inline int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count();
+}
+
+// State (written by the frame thread only)
+inline std::array<FrameRecord, TRACE_CAPACITY> ring;
+inline uint64_t frames_recorded = 0;
+inline FrameRecord current;
+
+inline int64_t budget_ns = 16'666'667;
+inline uint64_t budget_misses = 0;
+inline Stage last_miss_stage = Stage::Frame;
+inline int64_t last_miss_ns = 0;
+
+// Only the thread that called BeginFrame records; stage scopes on other
+// threads (benchmarks, workers) are no-ops.
+inline thread_local bool recording = false;
+
+inline void Record(Stage stage, int64_t begin_ns, int64_t duration_ns) {
+    if (!recording) return;
+    const size_t s = static_cast<size_t>(stage);
+    const uint32_t bit = 1u << s;
+    if (!(current.entered & bit)) {
+        current.entered |= bit;
+        current.begin_ns[s] = begin_ns;
+        current.total_ns[s] = 0;
+    }
+    current.total_ns[s] += duration_ns;
+}
+
+inline void BeginFrame() {
+    recording = true;
+    current.frame = frames_recorded;
+    current.entered = 0;
+    current.begin_ns[0] = Now();
+}
+
+// Drops the frame in progress, e.g. an idle frame that drew nothing and
+// would only skew the percentiles
+inline void DiscardFrame() {
+    recording = false;
+}
+
+inline void EndFrame() {
+    if (!recording) return;
+    const int64_t begin = current.begin_ns[0];
+    const int64_t end = Now();
+    current.entered |= 1u;
+    current.total_ns[0] = end - begin;
+
+    if (current.total_ns[0] > budget_ns) {
+        // Blame the slowest leaf stage of the frame thread
+        ++budget_misses;
+        last_miss_ns = current.total_ns[0];
+        int64_t worst = -1;
+        for (size_t s = 1; s < STAGE_COUNT; ++s) {
+            if (STAGES[s].thread != 0 || !IsLeaf(s) || !(current.entered & (1u << s))) continue;
+            if (current.total_ns[s] > worst) {
+                worst = current.total_ns[s];
+                last_miss_stage = static_cast<Stage>(s);
+            }
+        }
+    }
+
+    ring[frames_recorded % TRACE_CAPACITY] = current;
+    ++frames_recorded;
+}
+
+inline size_t FramesAvailable() {
+    return static_cast<size_t>(std::min<uint64_t>(frames_recorded, TRACE_CAPACITY));
+}
+
+// Rolling percentiles over the last `window` frames that entered the stage
+inline StageStats Stats(Stage stage, size_t window = STATS_WINDOW) {
+    const size_t s = static_cast<size_t>(stage);
+    std::array<int64_t, TRACE_CAPACITY> samples;
+    size_t n = 0;
+    const size_t frames = std::min(window, FramesAvailable());
+    for (size_t i = 0; i < frames; ++i) {
+        const FrameRecord& r = ring[(frames_recorded - 1 - i) % TRACE_CAPACITY];
+        if (r.entered & (1u << s)) samples[n++] = r.total_ns[s];
+    }
+    StageStats stats;
+    stats.samples = n;
+    if (n == 0) return stats;
+    std::sort(samples.begin(), samples.begin() + n);
+    stats.p50_ns = samples[n / 2];
+    stats.p99_ns = samples[std::min(n - 1, n * 99 / 100)];
+    return stats;
+}
+
+// ─────────────────────────────────────────────
+// Scoped stage timer
+// ─────────────────────────────────────────────
+
+class Scope {
+public:
+    explicit Scope(Stage stage) : stage_(stage), begin_(recording ? Now() : 0) {}
+    ~Scope() {
+        if (recording) Record(stage_, begin_, Now() - begin_);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Stage stage_;
+    int64_t begin_;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PROFILER_ENABLED
+#define PROFILE_SCOPE(stage) \
+    ::Profiler::Scope PROFILE_CONCAT(profile_scope_, __LINE__)(::Profiler::Stage::stage)
+#else
+#define PROFILE_SCOPE(stage) ((void)0)
+#endif
+
+// ─────────────────────────────────────────────
+// Trace export
+// ─────────────────────────────────────────────
+
+// One row per frame, one column of nanoseconds per stage (empty if the
+// stage did not run that frame)
+inline void WriteCsv(std::ostream& out) {
+    out << "frame,start_ns";
+    for (const StageInfo& info : STAGES) out << ',' << info.name;
+    out << ",over_budget\n";
+
+    const size_t frames = FramesAvailable();
+    for (uint64_t f = frames_recorded - frames; f < frames_recorded; ++f) {
+        const FrameRecord& r = ring[f % TRACE_CAPACITY];
+        out << r.frame << ',' << r.begin_ns[0];
+        for (size_t s = 0; s < STAGE_COUNT; ++s) {
+            out << ',';
+            if (r.entered & (1u << s)) out << r.total_ns[s];
+        }
+        out << ',' << (r.total_ns[0] > budget_ns ? 1 : 0) << '\n';
+    }
+}
+
+// Chrome trace event format (chrome://tracing, Perfetto). Stages become
+// complete ("X") events; siblings whose summed spans would overlap are laid
+// end to end so the nesting stays valid.
+inline void WriteChromeTrace(std::ostream& out) {
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    auto emit = [&](const char* name, int tid, int64_t ts_ns, int64_t dur_ns, uint64_t frame) {
+        char line[192];
+        std::snprintf(line, sizeof(line),
+                      "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                      "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}",
+                      first ? "" : ",\n", name, tid + 1, ts_ns / 1000.0, dur_ns / 1000.0,
+                      static_cast<unsigned long long>(frame));
+        out << line;
+        first = false;
+    };
+
+    const size_t frames = FramesAvailable();
+    for (uint64_t f = frames_recorded - frames; f < frames_recorded; ++f) {
+        const FrameRecord& r = ring[f % TRACE_CAPACITY];
+        std::array<int64_t, STAGE_COUNT> placed{};
+        std::array<int64_t, STAGE_COUNT> cursor{}; // end of the last child, per parent
+        for (size_t s = 0; s < STAGE_COUNT; ++s) {
+            if (!(r.entered & (1u << s))) continue;
+            const int parent = STAGES[s].parent;
+            int64_t ts = r.begin_ns[s];
+            if (parent != NO_PARENT) ts = std::max({ts, placed[parent], cursor[parent]});
+            placed[s] = ts;
+            if (parent != NO_PARENT) cursor[parent] = ts + r.total_ns[s];
+            emit(STAGES[s].name, STAGES[s].thread, ts, r.total_ns[s], r.frame);
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+// Path the trace is written to at exit; ".json" selects the Chrome format
+inline std::string trace_path;
+
+inline void WriteTrace() {
+    if (trace_path.empty()) return;
+    std::ofstream out(trace_path);
+    if (!out) return;
+    const bool json = trace_path.size() >= 5 &&
+                      trace_path.compare(trace_path.size() - 5, 5, ".json") == 0;
+    if (json) WriteChromeTrace(out);
+    else WriteCsv(out);
+}
+
+inline void DumpTraceAtExit(const std::string& path) {
+    const bool registered = !trace_path.empty();
+    trace_path = path;
+    if (!registered) std::atexit(WriteTrace);
+}
+
+} // namespace Profiler
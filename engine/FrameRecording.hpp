@@ -0,0 +1,320 @@
+#pragma once
+#include "FrameBuffer.hpp"
+#include "Surface.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace FrameIO {
+
+// ─────────────────────────────────────────────
+// Recorded frame stream
+// ─────────────────────────────────────────────
+//
+// Binary layout (native byte order):
+//
+//   header   "TFRB" | u16 version | u16 keyframe interval | u32 frame count | u32 0
+//   key      u8 1 | u16 width | u16 height | width*height cells
+//   delta    u8 2 | u16 changed rows | rows...
+//     row    u16 y | u16 spans | spans...
+//     span   u16 x | u16 length | cells
+//
+// A keyframe is written every `keyframe_interval` frames, on any size change,
+// and whenever a delta would come out larger than the full frame. Between
+// keyframes only the changed runs of each changed row are stored.
+
+inline constexpr char RECORDING_MAGIC[4] = {'T', 'F', 'R', 'B'};
+inline constexpr uint16_t RECORDING_VERSION = 1;
+inline constexpr size_t RECORDING_HEADER_SIZE = 16;
+
+enum RecordKind : uint8_t {
+    RECORD_KEY = 1,
+    RECORD_DELTA = 2
+};
+
+// Writes frames into a memory-mapped file that grows by doubling; Close()
+// trims it to the bytes actually written.
+class FrameRecorder {
+public:
+    static constexpr uint16_t DEFAULT_KEYFRAME_INTERVAL = 120;
+
+    FrameRecorder() = default;
+    ~FrameRecorder() { Close(); }
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    bool Open(const std::string& path, uint16_t keyframe_interval = DEFAULT_KEYFRAME_INTERVAL) {
+        Close();
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) return false;
+        keyframe_interval_ = std::max<uint16_t>(keyframe_interval, 1);
+        frames_ = 0;
+        size_ = 0;
+        if (!Reserve(INITIAL_MAPPING)) {
+            Close();
+            return false;
+        }
+        uint8_t header[RECORDING_HEADER_SIZE] = {};
+        std::memcpy(header, RECORDING_MAGIC, 4);
+        std::memcpy(header + 4, &RECORDING_VERSION, 2);
+        std::memcpy(header + 6, &keyframe_interval_, 2);
+        Put(header, sizeof(header));
+        return true;
+    }
+
+    inline bool is_open() const { return fd_ >= 0; }
+    inline uint32_t frames() const { return frames_; }
+    inline size_t bytes_written() const { return size_; }
+
+    bool Append(const Frame& frame) {
+        if (fd_ < 0 || frame.width() > UINT16_MAX || frame.height() > UINT16_MAX) return false;
+
+        const size_t cells = static_cast<size_t>(frame.width()) * frame.height();
+        const size_t key_size = 5 + cells;
+        const bool key = frames_ % keyframe_interval_ == 0 ||
+                         frame.width() != prev_.width() || frame.height() != prev_.height();
+
+        // Worst case for a delta is every other cell changed on every row
+        const size_t delta_bound =
+            3 + frame.height() * (4 + frame.width() + 4 * ((frame.width() + 1) / 2));
+        if (!Reserve(std::max(key_size, delta_bound))) return false;
+
+        if (key || !PutDelta(frame, key_size)) PutKey(frame);
+        CopyBuffer(prev_, frame);
+
+        ++frames_;
+        std::memcpy(map_ + 8, &frames_, 4);
+        return true;
+    }
+
+    // Unmaps and truncates the file to its final size
+    bool Close() {
+        if (fd_ < 0) return true;
+        bool ok = true;
+        if (map_) {
+            ok = ::munmap(map_, mapped_) == 0;
+            map_ = nullptr;
+            mapped_ = 0;
+        }
+        ok = ::ftruncate(fd_, static_cast<off_t>(size_)) == 0 && ok;
+        ok = ::close(fd_) == 0 && ok;
+        fd_ = -1;
+        prev_.Resize(0, 0);
+        return ok;
+    }
+
+private:
+    static constexpr size_t INITIAL_MAPPING = 1 << 20;
+
+    bool Reserve(size_t extra) {
+        const size_t needed = size_ + extra;
+        if (needed <= mapped_) return true;
+        size_t capacity = std::max(mapped_, INITIAL_MAPPING);
+        while (capacity < needed) capacity *= 2;
+        if (::ftruncate(fd_, static_cast<off_t>(capacity)) != 0) return false;
+        void* map = map_
+            ? ::mremap(map_, mapped_, capacity, MREMAP_MAYMOVE)
+            : ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (map == MAP_FAILED) return false;
+        map_ = static_cast<uint8_t*>(map);
+        mapped_ = capacity;
+        return true;
+    }
+
+    inline void Put(const void* data, size_t n) {
+        std::memcpy(map_ + size_, data, n);
+        size_ += n;
+    }
+
+    template <typename T>
+    inline void PutValue(T value) { Put(&value, sizeof(T)); }
+
+    void PutKey(const Frame& frame) {
+        PutValue<uint8_t>(RECORD_KEY);
+        PutValue<uint16_t>(static_cast<uint16_t>(frame.width()));
+        PutValue<uint16_t>(static_cast<uint16_t>(frame.height()));
+        for (int y = 0; y < frame.height(); ++y)
+            Put(frame[y], static_cast<size_t>(frame.width()));
+    }
+
+    // Unchanged gaps shorter than a span header are stored rather than split
+    static constexpr int MERGE_GAP = 4;
+
+    // Returns false (and writes nothing) if the delta is not smaller than a key
+    bool PutDelta(const Frame& frame, size_t key_size) {
+        const size_t start = size_;
+        const int width = frame.width();
+        uint16_t rows = 0;
+        PutValue<uint8_t>(RECORD_DELTA);
+        PutValue<uint16_t>(0); // patched below
+
+        for (int y = 0; y < frame.height(); ++y) {
+            const char* cur = frame[y];
+            const char* prev = prev_[y];
+            if (std::memcmp(cur, prev, width) == 0) continue;
+
+            const size_t row_start = size_;
+            uint16_t spans = 0;
+            PutValue<uint16_t>(static_cast<uint16_t>(y));
+            PutValue<uint16_t>(0); // patched below
+
+            int x = 0;
+            while (x < width) {
+                while (x < width && cur[x] == prev[x]) ++x;
+                if (x == width) break;
+                const int begin = x;
+                int end = x;
+                while (x < width) {
+                    if (cur[x] != prev[x]) { end = ++x; continue; }
+                    if (x - end >= MERGE_GAP) break;
+                    ++x;
+                }
+                PutValue<uint16_t>(static_cast<uint16_t>(begin));
+                PutValue<uint16_t>(static_cast<uint16_t>(end - begin));
+                Put(cur + begin, static_cast<size_t>(end - begin));
+                ++spans;
+                x = end;
+            }
+            std::memcpy(map_ + row_start + 2, &spans, 2);
+            ++rows;
+        }
+        std::memcpy(map_ + start + 1, &rows, 2);
+
+        if (size_ - start >= key_size) {
+            size_ = start;
+            return false;
+        }
+        return true;
+    }
+
+    int fd_ = -1;
+    uint8_t* map_ = nullptr;
+    size_t mapped_ = 0;
+    size_t size_ = 0;
+    uint16_t keyframe_interval_ = DEFAULT_KEYFRAME_INTERVAL;
+    uint32_t frames_ = 0;
+    Frame prev_;
+};
+
+// Maps a recording read-only and reconstructs its frames in order
+class FrameReader {
+public:
+    FrameReader() = default;
+    ~FrameReader() { Close(); }
+
+    FrameReader(const FrameReader&) = delete;
+    FrameReader& operator=(const FrameReader&) = delete;
+
+    bool Open(const std::string& path) {
+        Close();
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < RECORDING_HEADER_SIZE) {
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* map = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            size_ = 0;
+            return false;
+        }
+        map_ = static_cast<const uint8_t*>(map);
+        ::madvise(map, size_, MADV_SEQUENTIAL);
+
+        uint16_t version = 0;
+        std::memcpy(&version, map_ + 4, 2);
+        std::memcpy(&keyframe_interval_, map_ + 6, 2);
+        std::memcpy(&frame_count_, map_ + 8, 4);
+        if (std::memcmp(map_, RECORDING_MAGIC, 4) != 0 || version != RECORDING_VERSION) {
+            Close();
+            return false;
+        }
+        Rewind();
+        return true;
+    }
+
+    void Close() {
+        if (map_) ::munmap(const_cast<uint8_t*>(map_), size_);
+        map_ = nullptr;
+        size_ = 0;
+    }
+
+    inline void Rewind() {
+        pos_ = RECORDING_HEADER_SIZE;
+        index_ = 0;
+    }
+
+    inline uint32_t frame_count() const { return frame_count_; }
+    inline uint32_t index() const { return index_; }
+    inline uint16_t keyframe_interval() const { return keyframe_interval_; }
+
+    // The most recently decoded frame
+    inline const Frame& frame() const { return frame_; }
+
+    // Decodes the next frame; false at the end of the stream or on a
+    // truncated/corrupt record
+    bool Next() {
+        if (!map_ || index_ >= frame_count_) return false;
+        uint8_t kind;
+        if (!Get(kind)) return false;
+
+        if (kind == RECORD_KEY) {
+            uint16_t width, height;
+            if (!Get(width) || !Get(height)) return false;
+            const size_t cells = static_cast<size_t>(width) * height;
+            if (size_ - pos_ < cells) return false;
+            frame_.Resize(width, height);
+            for (int y = 0; y < height; ++y)
+                std::memcpy(frame_[y], map_ + pos_ + static_cast<size_t>(y) * width, width);
+            pos_ += cells;
+        } else if (kind == RECORD_DELTA) {
+            if (frame_.empty()) return false;
+            uint16_t rows;
+            if (!Get(rows)) return false;
+            for (uint16_t r = 0; r < rows; ++r) {
+                uint16_t y, spans;
+                if (!Get(y) || !Get(spans) || y >= frame_.height()) return false;
+                for (uint16_t s = 0; s < spans; ++s) {
+                    uint16_t x, length;
+                    if (!Get(x) || !Get(length)) return false;
+                    if (x + length > frame_.width() || size_ - pos_ < length) return false;
+                    std::memcpy(frame_[y] + x, map_ + pos_, length);
+                    pos_ += length;
+                }
+            }
+        } else {
+            return false;
+        }
+        ++index_;
+        return true;
+    }
+
+private:
+    template <typename T>
+    inline bool Get(T& value) {
+        if (size_ - pos_ < sizeof(T)) return false;
+        std::memcpy(&value, map_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    const uint8_t* map_ = nullptr;
+    size_t size_ = 0;
+    size_t pos_ = 0;
+    uint32_t index_ = 0;
+    uint32_t frame_count_ = 0;
+    uint16_t keyframe_interval_ = 0;
+    Frame frame_;
+};
+
+} // namespace FrameIO
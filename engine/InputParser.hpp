@@ -0,0 +1,233 @@
+#pragma once
+#include "KeyMap.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// ─────────────────────────────────────────────
+// Terminal input decoding
+// ─────────────────────────────────────────────
+//
+// Raw terminal bytes go into a ring buffer in bulk reads and come out as
+// events: plain bytes are keys, CSI/SS3 escape sequences become the
+// extended keys of KeyMap.hpp (arrows, Home/End, F1-F4...) with their
+// modifiers, and SGR mouse reports (ESC [ < b ; x ; y M/m) become mouse
+// events. A sequence split across reads waits in the ring for the rest,
+// even when the split falls right after its ESC: a lone trailing ESC is
+// only taken as the Escape key by Idle(), once a poll brings nothing more.
+
+enum class InputType : uint8_t {
+    Key,
+    MousePress,
+    MouseRelease,
+    MouseMove, // motion with a button held
+    Wheel,
+};
+
+struct InputEvent {
+    InputType type = InputType::Key;
+    uint8_t mods = 0; // Mod::SHIFT | Mod::ALT | Mod::CTRL
+    int16_t x = 0;    // mouse cell, 0-based
+    int16_t y = 0;
+    int code = 0;     // key code; Key::MOUSE_* / Key::WHEEL_* for mouse events
+};
+
+namespace Mod {
+    inline constexpr uint8_t SHIFT = 1;
+    inline constexpr uint8_t ALT = 2;
+    inline constexpr uint8_t CTRL = 4;
+}
+
+class InputParser {
+public:
+    static constexpr size_t CAPACITY = 1024; // power of two
+    static constexpr size_t MAX_SEQUENCE = 32; // longer sequences are dropped
+
+    // Contiguous free space to read() into, then Commit() what was read
+    inline std::span<char> WriteSpace() {
+        const size_t head = head_ & MASK;
+        const size_t free = CAPACITY - (head_ - tail_);
+        return {buffer_.data() + head, std::min(free, CAPACITY - head)};
+    }
+
+    inline void Commit(size_t n) { head_ += n; }
+
+    inline size_t buffered() const { return head_ - tail_; }
+
+    // Decodes every complete event in the buffer, calling sink(InputEvent)
+    // for each; an unfinished escape sequence is kept for the next call
+    template <typename Sink>
+    inline void Parse(Sink&& sink) {
+        while (tail_ != head_) {
+            const size_t used = Decode(sink);
+            if (used == 0) break; // incomplete sequence
+            tail_ += used;
+        }
+    }
+
+    // Call when a poll read nothing: a lone ESC still waiting from an
+    // earlier read was not the start of a sequence, so it is the Escape key
+    template <typename Sink>
+    inline void Idle(Sink&& sink) {
+        if (available() != 1 || discarding_ || At(0) != ESC) return;
+        sink(KeyEvent(Key::ESC));
+        ++tail_;
+    }
+
+private:
+    static constexpr size_t MASK = CAPACITY - 1;
+    static constexpr char ESC = 27;
+
+    inline size_t available() const { return head_ - tail_; }
+    inline char At(size_t i) const { return buffer_[(tail_ + i) & MASK]; }
+
+    static InputEvent KeyEvent(int code, uint8_t mods = 0) {
+        InputEvent e;
+        e.code = code;
+        e.mods = mods;
+        return e;
+    }
+
+    // xterm encodes modifiers as 1 + (shift | alt << 1 | ctrl << 2)
+    static uint8_t Modifiers(int param) {
+        return param > 1 ? static_cast<uint8_t>((param - 1) & 7) : 0;
+    }
+
+    // Decodes one event at the tail; returns the bytes it used, 0 if the
+    // sequence there is not complete yet
+    template <typename Sink>
+    size_t Decode(Sink& sink) {
+        const char c = At(0);
+        if (discarding_) {
+            if (c >= 0x40 && c <= 0x7E) discarding_ = false;
+            return 1;
+        }
+        if (c != ESC) {
+            sink(KeyEvent(static_cast<unsigned char>(c)));
+            return 1;
+        }
+        if (available() == 1) return 0; // the rest may be in the next read (see Idle)
+        const char next = At(1);
+        if (next == '[') return DecodeCsi(sink);
+        if (next == 'O') return DecodeSs3(sink);
+        if (next == ESC) {
+            sink(KeyEvent(Key::ESC));
+            return 1;
+        }
+        // ESC + key is how terminals send Alt+key
+        sink(KeyEvent(static_cast<unsigned char>(next), Mod::ALT));
+        return 2;
+    }
+
+    // ESC O <final>: arrows and Home/End in application mode, F1-F4
+    template <typename Sink>
+    size_t DecodeSs3(Sink& sink) {
+        if (available() < 3) return 0;
+        const int code = FinalKey(At(2));
+        if (code) sink(KeyEvent(code));
+        return 3;
+    }
+
+    static int FinalKey(char final) {
+        switch (final) {
+        case 'A': return Key::ARROW_UP;
+        case 'B': return Key::ARROW_DOWN;
+        case 'C': return Key::ARROW_RIGHT;
+        case 'D': return Key::ARROW_LEFT;
+        case 'H': return Key::HOME;
+        case 'F': return Key::END;
+        case 'P': return Key::F1;
+        case 'Q': return Key::F2;
+        case 'R': return Key::F3;
+        case 'S': return Key::F4;
+        default: return 0;
+        }
+    }
+
+    // ESC [ <n> ~ keys
+    static int TildeKey(int n) {
+        switch (n) {
+        case 1: case 7: return Key::HOME;
+        case 2: return Key::INSERT;
+        case 3: return Key::DEL;
+        case 4: case 8: return Key::END;
+        case 5: return Key::PAGE_UP;
+        case 6: return Key::PAGE_DOWN;
+        case 11: return Key::F1;
+        case 12: return Key::F2;
+        case 13: return Key::F3;
+        case 14: return Key::F4;
+        default: return 0;
+        }
+    }
+
+    // ESC [ [<] params final
+    template <typename Sink>
+    size_t DecodeCsi(Sink& sink) {
+        std::array<int, 4> params{};
+        size_t count = 0;
+        bool sgr_mouse = false;
+        size_t i = 2;
+        for (;; ++i) {
+            if (i > MAX_SEQUENCE) { // garbage: drop it up to its final byte
+                discarding_ = true;
+                return i;
+            }
+            if (i == available()) return 0; // wait for the rest
+            const char b = At(i);
+            if (b >= '0' && b <= '9') {
+                if (count == 0) count = 1;
+                if (count <= params.size() && params[count - 1] < 100000)
+                    params[count - 1] = params[count - 1] * 10 + (b - '0');
+            } else if (b == ';') {
+                count = (count == 0 ? 1 : count) + 1;
+            } else if (b == '<' && i == 2) {
+                sgr_mouse = true;
+            } else if (b >= 0x40 && b <= 0x7E) {
+                break; // final byte
+            } else if (b < 0x20 || b > 0x3F) {
+                return i; // not a CSI sequence after all
+            }
+        }
+        const char final = At(i);
+        const size_t used = i + 1;
+
+        if (sgr_mouse) {
+            if ((final == 'M' || final == 'm') && count >= 3) DecodeMouse(sink, params, final == 'm');
+            return used;
+        }
+        const int code = final == '~' ? TildeKey(params[0]) : FinalKey(final);
+        if (code) sink(KeyEvent(code, Modifiers(params[1])));
+        return used;
+    }
+
+    // SGR mouse: b = button (0-2) | shift 4 | alt 8 | ctrl 16 | motion 32
+    // | wheel 64; x and y are 1-based cells; 'm' ends a press
+    template <typename Sink>
+    static void DecodeMouse(Sink& sink, const std::array<int, 4>& params, bool release) {
+        const int b = params[0];
+        InputEvent e;
+        e.x = static_cast<int16_t>(params[1] - 1);
+        e.y = static_cast<int16_t>(params[2] - 1);
+        e.mods = static_cast<uint8_t>((b >> 2) & 7);
+        if (b & 64) {
+            e.type = InputType::Wheel;
+            e.code = (b & 1) ? Key::WHEEL_DOWN : Key::WHEEL_UP;
+        } else {
+            static constexpr int BUTTONS[4] = {Key::MOUSE_LEFT, Key::MOUSE_MIDDLE, Key::MOUSE_RIGHT, 0};
+            e.code = BUTTONS[b & 3];
+            e.type = release ? InputType::MouseRelease
+                   : (b & 32) ? InputType::MouseMove
+                   : InputType::MousePress;
+        }
+        sink(e);
+    }
+
+    std::array<char, CAPACITY> buffer_{};
+    size_t head_ = 0; // total bytes committed
+    size_t tail_ = 0; // total bytes parsed
+    bool discarding_ = false;
+};
@@ -10,11 +10,38 @@ namespace Key {
     inline constexpr int D = 'd';
     inline constexpr int Q = 'q';
     inline constexpr int E = 'e';
+    inline constexpr int L = 'l';
+    inline constexpr int M = 'm';
 
     inline constexpr int UP    = 'w';  // map to your scheme
     inline constexpr int DOWN  = 's';
     inline constexpr int LEFT  = 'a';
     inline constexpr int RIGHT = 'd';
 
-    // Arrow keys can be implemented later as ESC sequences
+    // Codes 0-255 are raw bytes; keys decoded from escape sequences and
+    // mouse buttons follow (InputParser.hpp). All fit in CODES.
+    inline constexpr int ARROW_UP    = 256;
+    inline constexpr int ARROW_DOWN  = 257;
+    inline constexpr int ARROW_RIGHT = 258;
+    inline constexpr int ARROW_LEFT  = 259;
+    inline constexpr int HOME        = 260;
+    inline constexpr int END         = 261;
+    inline constexpr int INSERT      = 262;
+    inline constexpr int DEL         = 263;
+    inline constexpr int PAGE_UP     = 264;
+    inline constexpr int PAGE_DOWN   = 265;
+    inline constexpr int F1          = 266;
+    inline constexpr int F2          = 267;
+    inline constexpr int F3          = 268;
+    inline constexpr int F4          = 269;
+
+    // Held from press to release, unlike keys
+    inline constexpr int MOUSE_LEFT   = 270;
+    inline constexpr int MOUSE_MIDDLE = 271;
+    inline constexpr int MOUSE_RIGHT  = 272;
+
+    inline constexpr int WHEEL_UP     = 273;
+    inline constexpr int WHEEL_DOWN   = 274;
+
+    inline constexpr int CODES = 512;
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "DataTypes.hpp"
+#include <cmath>
 
 void BuildTriangleMesh(const Vec3_t& a,
                        const Vec3_t& b,
@@ -28,4 +29,36 @@ void BuildPyramidMesh(const Vec3_t& a,
     BuildTriangleMesh(a, b, apex, verts_out, tris_out);
     BuildTriangleMesh(b, c, apex, verts_out, tris_out);
     BuildTriangleMesh(c, a, apex, verts_out, tris_out);
-}
\ No newline at end of file
+}
+
+// UV sphere with shared vertices: `rings` latitude bands, `segments`
+// longitude slices. Triangles are wound so the outside is the front face
+// (see MeshNormals.hpp for the convention) and survives culling.
+inline void BuildSphereMesh(const Vec3_t& center,
+                            double radius,
+                            size_t rings,
+                            size_t segments,
+                            Vec3Buffer& verts_out,
+                            TriangleBuffer& tris_out) {
+    constexpr double PI = 3.14159265358979323846;
+    const size_t base = verts_out.size();
+    verts_out.reserve(base + (rings + 1) * (segments + 1));
+    for (size_t r = 0; r <= rings; ++r) {
+        const double phi = PI * static_cast<double>(r) / rings;
+        for (size_t s = 0; s <= segments; ++s) {
+            const double theta = 2.0 * PI * static_cast<double>(s) / segments;
+            verts_out.push_back(center.x + radius * std::sin(phi) * std::cos(theta),
+                                center.y + radius * std::cos(phi),
+                                center.z + radius * std::sin(phi) * std::sin(theta));
+        }
+    }
+    auto at = [&](size_t r, size_t s) { return base + r * (segments + 1) + s; };
+    for (size_t r = 0; r < rings; ++r) {
+        for (size_t s = 0; s < segments; ++s) {
+            if (r != 0)
+                tris_out.push_back(at(r, s), at(r + 1, s), at(r, s + 1));
+            if (r + 1 != rings)
+                tris_out.push_back(at(r, s + 1), at(r + 1, s), at(r + 1, s + 1));
+        }
+    }
+}
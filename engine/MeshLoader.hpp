@@ -0,0 +1,358 @@
+#pragma once
+#include "DataTypes.hpp"
+#include "AlignedLanes.hpp"
+#include "Validation.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace MeshIO {
+
+// ─────────────────────────────────────────────
+// Vertex welding
+// ─────────────────────────────────────────────
+//
+// Open-addressing hash set over the positions already in `out`; slots hold
+// vertex indices, so no key is stored twice. Positions weld only when they
+// are bit-identical (after folding -0.0 into 0.0).
+
+class VertexWelder {
+public:
+    explicit VertexWelder(Vec3Buffer& out) : out_(out) {
+        Rehash(out_.size() * 2);
+    }
+
+    // Index of the vertex at (x, y, z), appending it if it is new
+    size_t Insert(double x, double y, double z) {
+        x += 0.0; y += 0.0; z += 0.0; // -0.0 -> 0.0
+        const uint64_t h = Hash(x, y, z);
+        for (size_t slot = h & mask_;; slot = (slot + 1) & mask_) {
+            const size_t i = slots_[slot];
+            if (i == EMPTY) break;
+            if (out_.x()[i] == x && out_.y()[i] == y && out_.z()[i] == z) return i;
+        }
+        const size_t index = out_.size();
+        out_.push_back(x, y, z);
+        if ((index + 1) * 2 > slots_.size()) Rehash(slots_.size() * 2); // keeps load <= 1/2
+        else Place(h, index);
+        return index;
+    }
+
+private:
+    static constexpr size_t EMPTY = SIZE_MAX;
+
+    static uint64_t Hash(double x, double y, double z) {
+        uint64_t bx, by, bz;
+        std::memcpy(&bx, &x, 8);
+        std::memcpy(&by, &y, 8);
+        std::memcpy(&bz, &z, 8);
+        uint64_t h = bx * 0x9E3779B97F4A7C15ull ^ by * 0xC2B2AE3D27D4EB4Full ^ bz;
+        h ^= h >> 30; h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 27; h *= 0x94D049BB133111EBull;
+        h ^= h >> 31;
+        return h;
+    }
+
+    void Place(uint64_t h, size_t index) {
+        size_t slot = h & mask_;
+        while (slots_[slot] != EMPTY) slot = (slot + 1) & mask_;
+        slots_[slot] = index;
+    }
+
+    void Rehash(size_t capacity) {
+        size_t size = 64;
+        while (size < capacity) size *= 2;
+        slots_.assign(size, EMPTY);
+        mask_ = size - 1;
+        for (size_t i = 0; i < out_.size(); ++i)
+            Place(Hash(out_.x()[i], out_.y()[i], out_.z()[i]), i);
+    }
+
+    Vec3Buffer& out_;
+    std::vector<size_t> slots_;
+    size_t mask_ = 0;
+};
+
+// Merges duplicate positions in place, remaps `tris` and drops triangles
+// that collapse. Returns the number of vertices removed.
+inline size_t WeldVertices(Vec3Buffer& verts, TriangleBuffer& tris) {
+    Vec3Buffer welded;
+    welded.reserve(verts.size());
+    std::vector<size_t> remap(verts.size());
+    {
+        VertexWelder welder(welded);
+        for (size_t i = 0; i < verts.size(); ++i)
+            remap[i] = welder.Insert(verts.x()[i], verts.y()[i], verts.z()[i]);
+    }
+
+    size_t kept = 0;
+    for (const auto& tri : tris.indices) {
+        const size_t a = remap[tri[0]], b = remap[tri[1]], c = remap[tri[2]];
+        if (a == b || b == c || c == a) continue;
+        tris.indices[kept++] = {static_cast<uint32_t>(a), static_cast<uint32_t>(b),
+                                static_cast<uint32_t>(c)};
+    }
+    tris.indices.resize(kept);
+    tris.touch();
+
+    const size_t removed = verts.size() - welded.size();
+    verts = std::move(welded);
+    return removed;
+}
+
+// ─────────────────────────────────────────────
+// Streaming Wavefront OBJ loader
+// ─────────────────────────────────────────────
+//
+// Reads the file through a fixed-size window, so memory use is the mesh
+// itself plus one obj-index -> vertex remap entry per `v` line. Only `v` and
+// `f` records are used; polygons are fan-triangulated, `a/b/c` corners and
+// negative (relative) indices are accepted, and everything else is ignored.
+// OBJ faces are counter-clockwise seen from outside; each triangle's last
+// two corners are swapped on import to the engine's winding (MeshNormals.hpp),
+// so models show their outside. Appends to `verts`/`tris`; returns false on an I/O error, a malformed
+// `v`/`f` line, or (with validation on) a vertex that is not finite or out
+// of bounds.
+
+namespace detail {
+
+inline const char* SkipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    return p;
+}
+
+inline bool ParseObjLine(const char* p, const char* end,
+                         Vec3Buffer& verts, TriangleBuffer& tris,
+                         std::vector<size_t>& remap, VertexWelder* welder,
+                         std::vector<size_t>& face) {
+    p = SkipSpaces(p, end);
+    if (end - p < 2 || (p[1] != ' ' && p[1] != '\t')) return true;
+
+    if (p[0] == 'v') {
+        double v[3];
+        p += 2;
+        for (double& c : v) {
+            p = SkipSpaces(p, end);
+            auto [next, ec] = std::from_chars(p, end, c);
+            if (ec != std::errc()) return false;
+            p = next;
+        }
+        if (verts.size() > UINT32_MAX) return false; // beyond 32-bit indices
+        if (welder) {
+            remap.push_back(welder->Insert(v[0], v[1], v[2]));
+        } else {
+            remap.push_back(verts.size());
+            verts.push_back(v[0], v[1], v[2]);
+        }
+        return true;
+    }
+
+    if (p[0] == 'f') {
+        face.clear();
+        p += 2;
+        while (true) {
+            p = SkipSpaces(p, end);
+            if (p == end || *p == '#') break;
+            long long index = 0;
+            auto [next, ec] = std::from_chars(p, end, index);
+            if (ec != std::errc()) return false;
+            const long long count = static_cast<long long>(remap.size());
+            const long long resolved = index < 0 ? count + index : index - 1;
+            if (index == 0 || resolved < 0 || resolved >= count) return false;
+            face.push_back(remap[static_cast<size_t>(resolved)]);
+            p = next;
+            while (p < end && *p != ' ' && *p != '\t') ++p; // skip /vt/vn
+        }
+        for (size_t k = 2; k < face.size(); ++k) {
+            const size_t a = face[0], b = face[k - 1], c = face[k];
+            if (a == b || b == c || c == a) continue; // collapsed by welding
+            tris.indices.push_back({static_cast<uint32_t>(a), static_cast<uint32_t>(c),
+                                    static_cast<uint32_t>(b)});
+        }
+    }
+    return true;
+}
+
+} // namespace detail
+
+inline bool LoadObj(const std::string& path,
+                    Vec3Buffer& verts,
+                    TriangleBuffer& tris,
+                    bool weld = true) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    std::unique_ptr<VertexWelder> welder;
+    if (weld) welder = std::make_unique<VertexWelder>(verts);
+    std::vector<size_t> remap;
+    std::vector<size_t> face;
+
+    constexpr size_t WINDOW = 1 << 20;
+    std::vector<char> buffer(WINDOW);
+    size_t filled = 0;
+    bool ok = true;
+    bool eof = false;
+
+    while (ok && !eof) {
+        if (filled == buffer.size()) buffer.resize(buffer.size() * 2); // very long line
+        const ssize_t n = ::read(fd, buffer.data() + filled, buffer.size() - filled);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ok = false;
+            break;
+        }
+        eof = n == 0;
+        filled += static_cast<size_t>(n);
+
+        // Parse every complete line; at EOF the remainder is the last line
+        const char* p = buffer.data();
+        const char* end = p + filled;
+        while (ok) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!nl && !eof) break;
+            const char* line_end = nl ? nl : end;
+            const char* trimmed = line_end;
+            if (trimmed > p && trimmed[-1] == '\r') --trimmed;
+            ok = detail::ParseObjLine(p, trimmed, verts, tris, remap, welder.get(), face);
+            if (!nl) { p = end; break; }
+            p = nl + 1;
+        }
+        filled = static_cast<size_t>(end - p);
+        std::memmove(buffer.data(), p, filled);
+    }
+
+    ::close(fd);
+    tris.touch();
+    return ok && ValidateVertices(verts, path.c_str());
+}
+
+// ─────────────────────────────────────────────
+// Native binary mesh (.tmesh)
+// ─────────────────────────────────────────────
+//
+// Laid out so the position lanes can be mapped and used in place:
+//
+//   0   "TMSH" | u32 version | u64 vertices | u64 triangles | u64 lane stride
+//       | u64 lanes offset | u64 indices offset | u32 index bytes   (64 bytes)
+//   64  x lane | y lane | z lane   (doubles, `stride` apart, zero padded)
+//   ..  indices                    (u32, 3 per triangle)
+//
+// LoadMesh maps the file privately and adopts the lanes straight from the
+// mapping (see AlignedLanes::Adopt) and copies the index block in one go.
+
+inline constexpr char MESH_MAGIC[4] = {'T', 'M', 'S', 'H'};
+inline constexpr uint32_t MESH_VERSION = 1;
+inline constexpr size_t MESH_HEADER_SIZE = 64;
+
+struct MeshHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t vertices;
+    uint64_t triangles;
+    uint64_t stride;
+    uint64_t lanes_offset;
+    uint64_t indices_offset;
+    uint32_t index_bytes;
+    uint32_t reserved[3];
+};
+static_assert(sizeof(MeshHeader) == MESH_HEADER_SIZE);
+
+inline bool SaveMesh(const std::string& path,
+                     const Vec3Buffer& verts,
+                     const TriangleBuffer& tris) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    MeshHeader header = {};
+    std::memcpy(header.magic, MESH_MAGIC, 4);
+    header.version = MESH_VERSION;
+    header.vertices = verts.size();
+    header.triangles = tris.size();
+    header.stride = (verts.size() + SOA_LANE_PAD - 1) / SOA_LANE_PAD * SOA_LANE_PAD;
+    header.lanes_offset = MESH_HEADER_SIZE;
+    header.indices_offset = MESH_HEADER_SIZE + 3 * header.stride * sizeof(double);
+    header.index_bytes = sizeof(uint32_t);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const std::vector<double> padding(header.stride - verts.size(), 0.0);
+    for (std::span<const double> lane : {verts.x(), verts.y(), verts.z()}) {
+        out.write(reinterpret_cast<const char*>(lane.data()), lane.size_bytes());
+        out.write(reinterpret_cast<const char*>(padding.data()),
+                  padding.size() * sizeof(double));
+    }
+
+    out.write(reinterpret_cast<const char*>(tris.indices.data()),
+              tris.indices.size() * sizeof(tris.indices[0]));
+    return static_cast<bool>(out.flush());
+}
+
+// Replaces `verts`/`tris` with the mesh in `path`; a mesh whose vertices
+// do not validate is rejected like a malformed one
+inline bool LoadMesh(const std::string& path,
+                     Vec3Buffer& verts,
+                     TriangleBuffer& tris) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < MESH_HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+    std::shared_ptr<void> mapping(map, [size](void* p) { ::munmap(p, size); });
+
+    MeshHeader header;
+    std::memcpy(&header, map, sizeof(header));
+    const uint64_t lanes_bytes = 3 * header.stride * sizeof(double);
+    const uint64_t index_bytes = header.triangles * 3 * header.index_bytes;
+    if (std::memcmp(header.magic, MESH_MAGIC, 4) != 0 || header.version != MESH_VERSION ||
+        header.stride > size || header.triangles > size || // keeps the products below in range
+        header.index_bytes != sizeof(uint32_t) ||
+        header.stride < header.vertices || header.stride % SOA_LANE_PAD != 0 ||
+        header.lanes_offset % SOA_ALIGNMENT != 0)
+        return false;
+    // Offsets come from the file: bound each against the mapping by
+    // subtraction, so no sum can wrap past a check
+    if (header.lanes_offset < MESH_HEADER_SIZE || header.lanes_offset > size ||
+        lanes_bytes > size - header.lanes_offset ||
+        header.indices_offset > size || index_bytes > size - header.indices_offset ||
+        header.lanes_offset + lanes_bytes > header.indices_offset)
+        return false;
+
+    uint8_t* base = static_cast<uint8_t*>(map);
+    tris.indices.resize(header.triangles);
+    std::memcpy(tris.indices.data(), base + header.indices_offset, index_bytes);
+    for (const auto& tri : tris.indices)
+        if (std::max({tri[0], tri[1], tri[2]}) >= header.vertices) {
+            tris.clear();
+            return false;
+        }
+    tris.touch();
+
+    verts.lanes.Adopt(reinterpret_cast<double*>(base + header.lanes_offset),
+                      header.vertices, header.stride, std::move(mapping));
+    verts.touch();
+    if (!ValidateVertices(verts, path.c_str())) {
+        verts.clear();
+        tris.clear();
+        return false;
+    }
+    return true;
+}
+
+} // namespace MeshIO
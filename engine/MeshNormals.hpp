@@ -0,0 +1,92 @@
+#pragma once
+#include "DataTypes.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// ─────────────────────────────────────────────
+// Cached face planes and vertex normals
+// ─────────────────────────────────────────────
+//
+// Per triangle, the plane n . p = d through its corners, with n the
+// unnormalized cross product of its edges (so degenerate triangles get
+// n = 0). Per vertex, the area-weighted average of the normals of the
+// triangles around it, normalized. Both are in the mesh's own space and
+// only rebuilt when the vertex or triangle buffer's revision changes.
+//
+// With the camera's left-handed view basis, a triangle faces an eye at e
+// when n . e < d; this is the same test the fill pass otherwise does per
+// triangle in camera space. Face normals thus point away from the front
+// side; vertex normals are flipped to point out of it, so lighting can use
+// n . L directly.
+
+struct MeshNormals {
+    Vec3Buffer face;               // n, per triangle
+    std::vector<double> face_d;    // d, per triangle
+    Vec3Buffer vertex;             // unit, out of the front side (zero if unused)
+
+    uint64_t verts_revision = 0;   // Vec3Buffer revision this was built from
+    uint64_t tris_revision = 0;    // TriangleBuffer revision this was built from
+
+    // Rebuild if `verts` or `tris` changed since the last call. Returns true
+    // if rebuilt.
+    template <typename Index>
+    bool Update(const Vec3Buffer& verts, const TriangleList<Index>& tris) {
+        if (verts_revision == verts.revision && tris_revision == tris.revision) return false;
+        Build(verts, tris);
+        verts_revision = verts.revision;
+        tris_revision = tris.revision;
+        return true;
+    }
+
+    inline bool Facing(size_t tri, const Vec3_t& eye) const {
+        return face.x()[tri] * eye.x + face.y()[tri] * eye.y + face.z()[tri] * eye.z < face_d[tri];
+    }
+
+private:
+    template <typename Index>
+    void Build(const Vec3Buffer& verts, const TriangleList<Index>& tris) {
+        const size_t n = tris.size();
+        face.resize(n);
+        face_d.resize(n);
+        vertex.resize(verts.size());
+        std::fill(vertex.x().begin(), vertex.x().end(), 0.0);
+        std::fill(vertex.y().begin(), vertex.y().end(), 0.0);
+        std::fill(vertex.z().begin(), vertex.z().end(), 0.0);
+
+        for (size_t t = 0; t < n; ++t) {
+            const auto& tri = tris.indices[t];
+            const size_t i0 = tri[0], i1 = tri[1], i2 = tri[2];
+            const double x0 = verts.x()[i0], y0 = verts.y()[i0], z0 = verts.z()[i0];
+            const double ax = verts.x()[i1] - x0, ay = verts.y()[i1] - y0, az = verts.z()[i1] - z0;
+            const double bx = verts.x()[i2] - x0, by = verts.y()[i2] - y0, bz = verts.z()[i2] - z0;
+            const double nx = ay * bz - az * by;
+            const double ny = az * bx - ax * bz;
+            const double nz = ax * by - ay * bx;
+            face.x()[t] = nx;
+            face.y()[t] = ny;
+            face.z()[t] = nz;
+            face_d[t] = nx * x0 + ny * y0 + nz * z0;
+
+            // |n| is twice the area, so summing n weights faces by area
+            for (size_t i : {i0, i1, i2}) {
+                vertex.x()[i] += nx;
+                vertex.y()[i] += ny;
+                vertex.z()[i] += nz;
+            }
+        }
+
+        for (size_t i = 0; i < vertex.size(); ++i) {
+            const double x = vertex.x()[i], y = vertex.y()[i], z = vertex.z()[i];
+            const double len = std::sqrt(x * x + y * y + z * z);
+            if (len == 0.0) continue;
+            vertex.x()[i] = -x / len;
+            vertex.y()[i] = -y / len;
+            vertex.z()[i] = -z / len;
+        }
+        face.touch();
+        vertex.touch();
+    }
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include "DataTypes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// ─────────────────────────────────────────────
+// Cached mesh topology
+// ─────────────────────────────────────────────
+//
+// Unique edges and triangle adjacency derived from a TriangleBuffer. Built
+// with one sort over the triangles' half-edges, and only rebuilt when the
+// buffer's revision changes, so per-frame wireframe passes just iterate a
+// flat array.
+
+struct MeshTopology {
+    static constexpr uint32_t NO_NEIGHBOR = UINT32_MAX;
+
+    std::vector<Edge> edges; // sorted by (a, b), no duplicates
+
+    // adjacency[t][k] is the triangle sharing edge k of triangle t, where
+    // edge k runs from corner k to corner (k + 1) % 3. Non-manifold edges
+    // link the first two triangles found.
+    std::vector<std::array<uint32_t, 3>> adjacency;
+
+    uint64_t revision = 0; // TriangleBuffer revision this was built from
+
+    // Rebuild if `tris` changed since the last call. Returns true if rebuilt.
+    template <typename Index>
+    bool Update(const TriangleList<Index>& tris) {
+        if (revision == tris.revision) return false;
+        Build(tris);
+        revision = tris.revision;
+        return true;
+    }
+
+private:
+    struct HalfEdge {
+        size_t a, b;    // sorted endpoints
+        uint32_t tri;
+        uint32_t slot;
+    };
+
+    std::vector<HalfEdge> scratch_;
+
+    template <typename Index>
+    void Build(const TriangleList<Index>& tris) {
+        scratch_.clear();
+        scratch_.reserve(tris.size() * 3);
+        for (size_t t = 0; t < tris.size(); ++t) {
+            const auto& tri = tris.indices[t];
+            for (uint32_t k = 0; k < 3; ++k) {
+                const size_t i = tri[k], j = tri[(k + 1) % 3];
+                scratch_.push_back({std::min(i, j), std::max(i, j),
+                                    static_cast<uint32_t>(t), k});
+            }
+        }
+        std::sort(scratch_.begin(), scratch_.end(),
+                  [](const HalfEdge& l, const HalfEdge& r) {
+                      if (l.a != r.a) return l.a < r.a;
+                      if (l.b != r.b) return l.b < r.b;
+                      return l.tri < r.tri;
+                  });
+
+        edges.clear();
+        adjacency.assign(tris.size(), {NO_NEIGHBOR, NO_NEIGHBOR, NO_NEIGHBOR});
+
+        for (size_t i = 0; i < scratch_.size();) {
+            size_t j = i + 1;
+            while (j < scratch_.size() && scratch_[j].a == scratch_[i].a &&
+                   scratch_[j].b == scratch_[i].b)
+                ++j;
+
+            edges.emplace_back(scratch_[i].a, scratch_[i].b);
+            if (j - i >= 2) {
+                const HalfEdge& h0 = scratch_[i];
+                const HalfEdge& h1 = scratch_[i + 1];
+                adjacency[h0.tri][h0.slot] = h1.tri;
+                adjacency[h1.tri][h1.slot] = h0.tri;
+            }
+            i = j;
+        }
+    }
+};
@@ -0,0 +1,132 @@
+#pragma once
+#include "DataTypes.hpp"
+#include "CameraSettings.hpp"
+#include "Surface.hpp"
+#include "FilledRenderer.hpp"
+#include "FrameProfiler.hpp"
+#include "TransformStage.hpp"
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// ─────────────────────────────────────────────
+// Tile-binned multithreaded fill pass
+// ─────────────────────────────────────────────
+//
+// Triangles are culled and set up once on the calling thread, then binned
+// into the screen tiles their bounding box overlaps. Each tile is rasterized
+// by exactly one worker, clipped to the tile, so workers write disjoint
+// pixels of the shared framebuffer and depth buffer without locking.
+//
+// Within a tile, triangles are drawn in submission order and every pixel's
+// coverage and depth are computed from its absolute position, so the output
+// is bit-for-bit identical to RenderMeshFilled. Worker tiles are whole
+// depth pyramid tiles, so each worker also owns the pyramid entries it reads
+// and tightens, and the lazy clears of those tiles.
+
+class ParallelRasterizer {
+public:
+    static constexpr int TILE_W = 32;
+    static constexpr int TILE_H = 8;
+    static_assert(TILE_W % DepthBuffer::HIZ_TILE == 0 && TILE_H % DepthBuffer::HIZ_TILE == 0,
+                  "worker tiles must own whole depth pyramid tiles");
+
+    explicit ParallelRasterizer(unsigned thread_count = std::thread::hardware_concurrency())
+        : pool_(thread_count) {}
+
+    inline unsigned threads() const { return pool_.size(); }
+
+    template <typename Index, typename Format>
+    void RenderFilled(const TransformedVertices& xf,
+                      const TriangleList<Index>& tris,
+                      Frame& fb,
+                      DepthSurface<Format>& zbuf,
+                      const FillStyle& style = {},
+                      std::span<const uint32_t> order = {}) {
+        RenderFilled(xf, tris, fb, zbuf, fb.bounds(), style, order);
+    }
+
+    // Only pixels inside `scissor` (which must lie inside the surface) are
+    // written; worker tiles outside it get nothing binned
+    template <typename Index, typename Format>
+    void RenderFilled(const TransformedVertices& xf,
+                      const TriangleList<Index>& tris,
+                      Frame& fb,
+                      DepthSurface<Format>& zbuf,
+                      const PixelRect_t& scissor,
+                      const FillStyle& style = {},
+                      std::span<const uint32_t> order = {}) {
+        WithFillFeatures(FillFeaturesOf(style, xf), [&]<FillFeatures F>() {
+            RenderFilledWith<F>(xf, tris, fb, zbuf, scissor, style, order);
+        });
+    }
+
+    // The pass for one FillFeatures variant (see FillTrianglesWith)
+    template <FillFeatures F, typename Index, typename Format>
+    void RenderFilledWith(const TransformedVertices& xf,
+                          const TriangleList<Index>& tris,
+                          Frame& fb,
+                          DepthSurface<Format>& zbuf,
+                          const PixelRect_t& scissor,
+                          const FillStyle& style,
+                          std::span<const uint32_t> order = {}) {
+        if (scissor.empty()) return;
+        const bool partial = scissor != fb.bounds();
+        const int width = fb.width(), height = fb.height();
+        const int tiles_x = (width + TILE_W - 1) / TILE_W;
+        const int tiles_y = (height + TILE_H - 1) / TILE_H;
+        if (bins_.size() != static_cast<size_t>(tiles_x * tiles_y))
+            bins_.resize(tiles_x * tiles_y);
+
+        setups_.clear();
+        for (auto& bin : bins_) bin.clear();
+
+        // Setup + binning (serial, preserves submission order per tile)
+        {
+            PROFILE_SCOPE(Cull);
+            TriangleSetup_t clipped[MAX_CLIPPED_TRIANGLES];
+            for (size_t i = 0; i < tris.size(); ++i) {
+                const size_t t = order.empty() ? i : order[i];
+                if constexpr (F.cached_cull)
+                    if (!style.facing[t]) continue;
+                const size_t count = SetupMeshTriangle<F>(xf, tris.indices[t], width, height, clipped,
+                                                          style, partial ? &scissor : nullptr);
+                for (size_t k = 0; k < count; ++k) {
+                    const TriangleSetup_t& setup = clipped[k];
+                    const int minX = std::max(setup.minX, scissor.x0);
+                    const int maxX = std::min(setup.maxX, scissor.x1);
+                    const int minY = std::max(setup.minY, scissor.y0);
+                    const int maxY = std::min(setup.maxY, scissor.y1);
+                    if (minX > maxX || minY > maxY) continue;
+
+                    const uint32_t index = static_cast<uint32_t>(setups_.size());
+                    setups_.push_back(setup);
+                    for (int ty = minY / TILE_H; ty <= maxY / TILE_H; ++ty)
+                        for (int tx = minX / TILE_W; tx <= maxX / TILE_W; ++tx)
+                            bins_[ty * tiles_x + tx].push_back(index);
+                }
+            }
+        }
+
+        // Rasterize tiles in parallel
+        PROFILE_SCOPE(Raster);
+        pool_.ParallelFor(bins_.size(), [&](size_t tile) {
+            const int tx = static_cast<int>(tile) % tiles_x;
+            const int ty = static_cast<int>(tile) / tiles_x;
+            const int x0 = std::max(tx * TILE_W, scissor.x0);
+            const int y0 = std::max(ty * TILE_H, scissor.y0);
+            const int x1 = std::min(std::min(tx * TILE_W + TILE_W, width) - 1, scissor.x1);
+            const int y1 = std::min(std::min(ty * TILE_H + TILE_H, height) - 1, scissor.y1);
+            for (uint32_t index : bins_[tile])
+                RasterizeTriangle<F.depth_test>(setups_[index], x0, y0, x1, y1, fb, zbuf);
+        });
+    }
+
+private:
+    WorkerPool pool_;
+    std::vector<TriangleSetup_t> setups_;
+    std::vector<std::vector<uint32_t>> bins_;
+};
@@ -1,38 +1,197 @@
 #pragma once
 #include "FilledRenderer.hpp"
+#include "FrameProfiler.hpp"
 #include "WireframeRenderer.hpp"
+#include "TransformStage.hpp"
+#include "ParallelRenderer.hpp"
+#include "MeshTopology.hpp"
+#include "RenderPipeline.hpp"
+#include "Scene.hpp"
 
-// Renders filled triangles, then outlines over top
+// Renders filled triangles, then outlines over top. Vertices are transformed
+// once into `xf`, which both passes read by index, and the edge list comes
+// from `topo`, which is only rebuilt when `tris` changes; keep both alive
+// across frames. With `order`, triangles are filled front to back. To cull
+// and shade from cached normals, pass a style set up by MeshShading.
+// (RenderMesh in RenderPipeline.hpp with the Filled mode and an outline.)
+template <typename Positions, typename Index, typename Format>
 inline void RenderMeshComposite(
-    const Vec3Buffer& verts,
-    const TriangleBuffer& tris,
+    const Positions& verts,
+    const TriangleList<Index>& tris,
     const Vec3_t& eye,
     const Vec3_t& target,
-    char (&fb)[CameraSettings::screen_height][CameraSettings::screen_width],
-    double (&zbuf)[CameraSettings::screen_height][CameraSettings::screen_width],
-    char fillChar = '#',
+    TransformedVertices& xf,
+    MeshTopology& topo,
+    Frame& fb,
+    DepthSurface<Format>& zbuf,
+    const FillStyle& style = {},
+    char lineChar = '*',
+    FillOrder* order = nullptr
+) {
+    RenderSettings settings;
+    settings.style = style;
+    settings.line = lineChar;
+    RenderMesh(settings, verts, tris, eye, target, xf, topo, nullptr, fb, zbuf, order);
+}
+
+template <typename Positions, typename Index, typename Format>
+inline void RenderMeshComposite(
+    const Positions& verts,
+    const TriangleList<Index>& tris,
+    const Vec3_t& eye,
+    const Vec3_t& target,
+    Frame& fb,
+    DepthSurface<Format>& zbuf,
+    const FillStyle& style = {},
+    char lineChar = '*'
+) {
+    TransformedVertices xf;
+    MeshTopology topo;
+    RenderMeshComposite(verts, tris, eye, target, xf, topo, fb, zbuf, style, lineChar);
+}
+
+// Same as above, with the fill pass rasterized across the worker pool
+template <typename Positions, typename Index, typename Format>
+inline void RenderMeshComposite(
+    const Positions& verts,
+    const TriangleList<Index>& tris,
+    const Vec3_t& eye,
+    const Vec3_t& target,
+    TransformedVertices& xf,
+    MeshTopology& topo,
+    ParallelRasterizer& raster,
+    Frame& fb,
+    DepthSurface<Format>& zbuf,
+    const FillStyle& style = {},
+    char lineChar = '*',
+    FillOrder* order = nullptr
+) {
+    RenderSettings settings;
+    settings.style = style;
+    settings.line = lineChar;
+    RenderMesh(settings, verts, tris, eye, target, xf, topo, &raster, fb, zbuf, order);
+}
+
+// Renders every instance of `scene` that survives frustum culling, in one
+// fill pass and one outline pass over the batched vertex cache (see
+// Scene.hpp); keep `batch` alive across frames.
+template <typename Format>
+inline void RenderSceneComposite(
+    const SceneGraph& scene,
+    const Vec3_t& eye,
+    const Vec3_t& target,
+    SceneBatch& batch,
+    Frame& fb,
+    DepthSurface<Format>& zbuf,
+    const FillStyle& style = {},
     char lineChar = '*'
 ) {
-    // Fill first
-    RenderMeshFilled(verts, tris, eye, target, fb, zbuf, fillChar);
+    {
+        PROFILE_SCOPE(Transform);
+        BuildSceneBatch(scene, eye, target, batch, fb.aspect_ratio());
+    }
+    {
+        PROFILE_SCOPE(Fill);
+        RenderSceneFilled(batch, fb, zbuf, style);
+    }
+    PROFILE_SCOPE(Edges);
+    RenderEdges(batch.xf, batch.edges, fb, lineChar);
+}
 
-    // Outline last
-    auto edges = ExtractEdges(tris);
-    auto view = LookAt(eye, target, CAMERA_UP);
-    const double focal = CameraSettings::FovToFocalLength(CameraSettings::camera_fov);
+// Same as above, with the fill pass rasterized across the worker pool
+template <typename Format>
+inline void RenderSceneComposite(
+    const SceneGraph& scene,
+    const Vec3_t& eye,
+    const Vec3_t& target,
+    SceneBatch& batch,
+    ParallelRasterizer& raster,
+    Frame& fb,
+    DepthSurface<Format>& zbuf,
+    const FillStyle& style = {},
+    char lineChar = '*'
+) {
+    {
+        PROFILE_SCOPE(Transform);
+        BuildSceneBatch(scene, eye, target, batch, fb.aspect_ratio());
+    }
+    {
+        PROFILE_SCOPE(Fill);
+        raster.RenderFilled(batch.xf, batch.tris, fb, zbuf, SceneFillStyle(batch, style), batch.tri_order);
+    }
+    PROFILE_SCOPE(Edges);
+    RenderEdges(batch.xf, batch.edges, fb, lineChar);
+}
 
-    for (const auto& e : edges) {
-        Vec3Buffer cam;
-        WorldToCamera(verts, e.a, view, eye, cam);
-        WorldToCamera(verts, e.b, view, eye, cam);
-        if (cam.z[0] <= 0 || cam.z[1] <= 0) continue;
+// Outline pass over the instances of a batch that reach into `scissor`
+inline void RenderSceneEdges(const SceneBatch& batch, Frame& fb,
+                             const PixelRect_t& scissor, char lineChar = '*') {
+    const std::span<const Edge> edges(batch.edges);
+    for (size_t k = 0; k < batch.visible.size(); ++k) {
+        if (!CoverageRect(batch.coverage[k], fb.width(), fb.height()).Overlaps(scissor)) continue;
+        RenderEdges(batch.xf, edges.subspan(batch.first_edge[k], batch.first_edge[k + 1] - batch.first_edge[k]),
+                    fb, scissor, lineChar);
+    }
+}
 
-        Vec2Buffer proj;
-        ProjectToScreen(cam, 0, focal, CameraSettings::aspect_ratio, proj);
-        ProjectToScreen(cam, 1, focal, CameraSettings::aspect_ratio, proj);
+// Brings `fb` up to date with `scene` from the given camera, redrawing only
+// what changed since the last call with the same batch: nothing when the
+// camera, frame size and scene are unchanged; the screen rectangles that
+// moved instances left and entered when only instances moved (SceneDamage);
+// the whole frame otherwise. `fb` and `zbuf` must still hold what the last
+// call drew. Returns false when nothing was redrawn.
+template <typename Format>
+inline bool RenderSceneIncremental(
+    const SceneGraph& scene,
+    const Vec3_t& eye,
+    const Vec3_t& target,
+    SceneBatch& batch,
+    ParallelRasterizer* raster,
+    Frame& fb,
+    DepthSurface<Format>& zbuf,
+    DamageRegion& damage,
+    const FillStyle& style = {},
+    char lineChar = '*'
+) {
+    const bool reusable = SceneDrawnReusable(scene, batch, eye, target, fb.width(), fb.height());
+    if (reusable && scene.pose_revision() == batch.drawn.pose_revision) {
+        damage.Clear();
+        return false;
+    }
+    {
+        PROFILE_SCOPE(Transform);
+        BuildSceneBatch(scene, eye, target, batch, fb.aspect_ratio());
+    }
+    if (reusable)
+        SceneDamage(scene, batch, fb.width(), fb.height(), damage);
+    else
+        damage.rects.assign(1, fb.bounds());
+    NoteSceneDrawn(scene, batch, eye, target, fb.width(), fb.height());
 
-        Int2_t p0 = MapToScreen(proj, 0, CameraSettings::screen_width, CameraSettings::screen_height);
-        Int2_t p1 = MapToScreen(proj, 1, CameraSettings::screen_width, CameraSettings::screen_height);
-        DrawLine(p0, p1, fb, lineChar);
+    for (const PixelRect_t& r : damage.rects) {
+        {
+            PROFILE_SCOPE(Clear);
+            if (reusable) {
+                fb.FillRect(r, ' ');
+                zbuf.ClearRect(r, CameraSettings::far_plane);
+            } else {
+                fb.Fill(' ');
+                zbuf.Fill(CameraSettings::far_plane);
+            }
+        }
+        {
+            PROFILE_SCOPE(Fill);
+            if (raster)
+                raster->RenderFilled(batch.xf, batch.tris, fb, zbuf, r, SceneFillStyle(batch, style),
+                                     batch.tri_order);
+            else
+                RenderSceneFilled(batch, fb, zbuf, r, style);
+        }
+        PROFILE_SCOPE(Edges);
+        if (reusable)
+            RenderSceneEdges(batch, fb, r, lineChar);
+        else
+            RenderEdges(batch.xf, batch.edges, fb, lineChar);
     }
+    return !damage.empty();
 }
@@ -1,4 +1,7 @@
 #pragma once
+
+// Which passes draw a mesh (see RenderPipeline.hpp): outlines only, or
+// filled triangles with an optional outline over them
 enum class RenderMode {
     Wireframe,
     Filled
@@ -0,0 +1,132 @@
+#pragma once
+#include "DataTypes.hpp"
+#include "FilledRenderer.hpp"
+#include "FrameProfiler.hpp"
+#include "MeshTopology.hpp"
+#include "ParallelRenderer.hpp"
+#include "RenderMode.hpp"
+#include "Surface.hpp"
+#include "TransformStage.hpp"
+#include "WireframeRenderer.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+// ─────────────────────────────────────────────
+// Compile-time specialized mesh pipeline
+// ─────────────────────────────────────────────
+//
+// One frame of a mesh is: transform once into the vertex cache, then the
+// fill pass and/or the outline pass, both reading it by index. Which passes
+// run, and how the fill culls, depth tests and shades, is a PipelineFeatures
+// template parameter, so each combination compiles to its own loops with
+// the unused work removed. RenderMesh picks the variant from a runtime
+// RenderSettings with one lookup per frame, which is what lets modes be
+// switched live at the speed of a hand-specialized loop.
+
+struct PipelineFeatures {
+    RenderMode mode = RenderMode::Filled;
+    bool outline = true;  // edges over the fill (Filled only)
+    FillFeatures fill;    // unused in Wireframe
+
+    bool operator==(const PipelineFeatures&) const = default;
+};
+
+// What the caller switches at runtime
+struct RenderSettings {
+    RenderMode mode = RenderMode::Filled;
+    bool outline = true;
+    FillStyle style;
+    char line = '*';
+};
+
+// Features for a frame of `settings` over `xf` (whose `light` lane must
+// already be current); fill features are normalized away in Wireframe
+inline PipelineFeatures PipelineFeaturesOf(const RenderSettings& settings,
+                                           const TransformedVertices& xf) {
+    if (settings.mode == RenderMode::Wireframe) return {RenderMode::Wireframe, false, {}};
+    return {RenderMode::Filled, settings.outline, FillFeaturesOf(settings.style, xf)};
+}
+
+// Every PipelineFeatures PipelineFeaturesOf can return
+inline constexpr auto PIPELINE_VARIANTS = [] {
+    std::array<PipelineFeatures, 1 + 2 * FILL_VARIANTS.size()> variants{};
+    size_t n = 0;
+    variants[n++] = {RenderMode::Wireframe, false, {}};
+    for (bool outline : {false, true})
+        for (const FillFeatures& fill : FILL_VARIANTS)
+            variants[n++] = {RenderMode::Filled, outline, fill};
+    return variants;
+}();
+
+// Calls fn.template operator()<P>() for the variant P equal to `features`
+template <typename Fn, size_t... I>
+inline void WithPipelineFeatures(const PipelineFeatures& features, Fn&& fn, std::index_sequence<I...>) {
+    (void)((features == PIPELINE_VARIANTS[I] && (fn.template operator()<PIPELINE_VARIANTS[I]>(), true)) || ...);
+}
+
+template <typename Fn>
+inline void WithPipelineFeatures(const PipelineFeatures& features, Fn&& fn) {
+    WithPipelineFeatures(features, fn, std::make_index_sequence<PIPELINE_VARIANTS.size()>());
+}
+
+// One frame of the mesh for a single variant. `raster` (may be null) takes
+// the fill pass across the worker pool; with `order`, triangles are filled
+// front to back. Keep `xf` and `topo` alive across frames.
+template <PipelineFeatures P, typename Positions, typename Index, typename Format>
+inline void RenderMeshWith(const Positions& verts,
+                           const TriangleList<Index>& tris,
+                           const Vec3_t& eye,
+                           const Vec3_t& target,
+                           TransformedVertices& xf,
+                           MeshTopology& topo,
+                           ParallelRasterizer* raster,
+                           Frame& fb,
+                           DepthSurface<Format>& zbuf,
+                           const FillStyle& style,
+                           char lineChar = '*',
+                           FillOrder* order = nullptr) {
+    {
+        PROFILE_SCOPE(Transform);
+        TransformVertices(verts, eye, target, xf, fb.aspect_ratio());
+    }
+
+    if constexpr (P.mode == RenderMode::Filled) {
+        PROFILE_SCOPE(Fill);
+        if (order) order->Update(xf, tris);
+        const std::span<const uint32_t> fill_order =
+            order ? std::span<const uint32_t>(order->order) : std::span<const uint32_t>();
+        if (raster)
+            raster->RenderFilledWith<P.fill>(xf, tris, fb, zbuf, fb.bounds(), style, fill_order);
+        else
+            FillTrianglesWith<P.fill>(xf, std::span<const std::array<Index, 3>>(tris.indices),
+                                      fb, zbuf, fb.bounds(), style, fill_order);
+    }
+
+    if constexpr (P.mode == RenderMode::Wireframe || P.outline) {
+        PROFILE_SCOPE(Edges);
+        topo.Update(tris);
+        RenderEdges(xf, topo.edges, fb, lineChar);
+    }
+}
+
+// One frame of the mesh as `settings` asks
+template <typename Positions, typename Index, typename Format>
+inline void RenderMesh(const RenderSettings& settings,
+                       const Positions& verts,
+                       const TriangleList<Index>& tris,
+                       const Vec3_t& eye,
+                       const Vec3_t& target,
+                       TransformedVertices& xf,
+                       MeshTopology& topo,
+                       ParallelRasterizer* raster,
+                       Frame& fb,
+                       DepthSurface<Format>& zbuf,
+                       FillOrder* order = nullptr) {
+    WithPipelineFeatures(PipelineFeaturesOf(settings, xf), [&]<PipelineFeatures P>() {
+        RenderMeshWith<P>(verts, tris, eye, target, xf, topo, raster, fb, zbuf,
+                          settings.style, settings.line, order);
+    });
+}
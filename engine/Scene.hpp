@@ -0,0 +1,504 @@
+#pragma once
+#include "CameraMath.hpp"
+#include "CameraSettings.hpp"
+#include "DataTypes.hpp"
+#include "FilledRenderer.hpp"
+#include "MeshNormals.hpp"
+#include "MeshTopology.hpp"
+#include "Shading.hpp"
+#include "TransformStage.hpp"
+#include "Validation.hpp"
+#include "VectorBatch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// ─────────────────────────────────────────────
+// Scene graph: shared meshes and their instances
+// ─────────────────────────────────────────────
+//
+// A mesh is stored once, with its edge topology and local bounds; an
+// instance is a mesh id plus a model transform, with world bounds refreshed
+// whenever the transform is set. Nothing is copied per instance.
+//
+// Per frame, BuildSceneBatch rejects instances whose bounds lie outside the
+// view frustum and transforms the rest into one TransformedVertices, packed
+// back to back. The batch's triangle and edge lists index that cache and are
+// only rebuilt when the set of visible instances changes, so the fill and
+// outline passes run once over the whole scene. While the camera holds
+// still, only instances that moved are transformed again. The serial fill pass also
+// tests each instance's screen bounds against the depth pyramid and skips
+// hidden instances wholesale; with `front_to_back` set, instances are drawn
+// nearest first and the pyramid is tightened over each one drawn, so that
+// test rejects the instances behind them (about half of those in view with
+// the camera low inside a field; see scene_field_frame_low in EngineBench).
+//
+// Moving an instance stamps it with a new pose revision. A batch remembers
+// the camera, revisions and per-instance screen rectangles it was last
+// drawn with, so SceneDamage can tell which parts of that frame a move
+// invalidated (see RenderSceneIncremental).
+//
+// Each mesh caches its face planes and vertex normals. Whenever an instance
+// is transformed, the eye (and, for lit batches, the light) is taken into
+// the mesh's own space instead, so back faces are culled and vertices lit
+// from the cached normals without transforming a single normal.
+
+// Rotation about +y followed by a uniform scale, then a translation
+inline ModelTransform_t MakeModelTransform(const Vec3_t& position,
+                                           double yaw = 0.0,
+                                           double scale = 1.0) {
+    const double c = std::cos(yaw) * scale, s = std::sin(yaw) * scale;
+    return {{c, 0.0, -s}, {0.0, scale, 0.0}, {s, 0.0, c}, position};
+}
+
+inline Vec3_t ApplyModelTransform(const ModelTransform_t& m, const Vec3_t& p) {
+    return {m.position.x + m.x_axis.x * p.x + m.y_axis.x * p.y + m.z_axis.x * p.z,
+            m.position.y + m.x_axis.y * p.x + m.y_axis.y * p.y + m.z_axis.y * p.z,
+            m.position.z + m.x_axis.z * p.x + m.y_axis.z * p.y + m.z_axis.z * p.z};
+}
+
+inline double ModelDeterminant(const ModelTransform_t& m) {
+    return VecDotAtomic(m.x_axis, VecCrossAtomic(m.y_axis, m.z_axis));
+}
+
+// World point back into the model's own space (the transform must not be
+// singular)
+inline Vec3_t InverseModelTransform(const ModelTransform_t& m, const Vec3_t& p) {
+    const Vec3_t r = VecSubAtomic(p, m.position);
+    const double inv_det = 1.0 / ModelDeterminant(m);
+    return {VecDotAtomic(VecCrossAtomic(m.y_axis, m.z_axis), r) * inv_det,
+            VecDotAtomic(VecCrossAtomic(m.z_axis, m.x_axis), r) * inv_det,
+            VecDotAtomic(VecCrossAtomic(m.x_axis, m.y_axis), r) * inv_det};
+}
+
+// World light direction in the model's own space, such that its dot product
+// with a local unit normal is the Lambert term of the transformed normal.
+// Exact for rotations with a uniform scale (what MakeModelTransform builds).
+inline Vec3_t ModelLightDirection(const ModelTransform_t& m, const Vec3_t& direction) {
+    const double det = ModelDeterminant(m);
+    const double s = std::copysign(std::cbrt(std::abs(det)), det);
+    return {VecDotAtomic(m.x_axis, direction) / s,
+            VecDotAtomic(m.y_axis, direction) / s,
+            VecDotAtomic(m.z_axis, direction) / s};
+}
+
+// Axis-aligned box (center + half extents) and the sphere around it
+struct Bounds_t {
+    Vec3_t center = {0.0, 0.0, 0.0};
+    Vec3_t extent = {0.0, 0.0, 0.0};
+    double radius = 0.0;
+
+    static Bounds_t Of(const Vec3Buffer& verts) {
+        Bounds_t b;
+        if (verts.size() == 0) return b;
+        const auto [x0, x1] = std::minmax_element(verts.x().begin(), verts.x().end());
+        const auto [y0, y1] = std::minmax_element(verts.y().begin(), verts.y().end());
+        const auto [z0, z1] = std::minmax_element(verts.z().begin(), verts.z().end());
+        b.center = {(*x0 + *x1) * 0.5, (*y0 + *y1) * 0.5, (*z0 + *z1) * 0.5};
+        b.extent = {(*x1 - *x0) * 0.5, (*y1 - *y0) * 0.5, (*z1 - *z0) * 0.5};
+        double r2 = 0.0;
+        for (size_t i = 0; i < verts.size(); ++i) {
+            const double dx = verts.x()[i] - b.center.x;
+            const double dy = verts.y()[i] - b.center.y;
+            const double dz = verts.z()[i] - b.center.z;
+            r2 = std::max(r2, dx * dx + dy * dy + dz * dz);
+        }
+        b.radius = std::sqrt(r2);
+        return b;
+    }
+
+    // Bounds of this (local) box after `m`; conservative for rotations
+    Bounds_t Transformed(const ModelTransform_t& m) const {
+        auto reach = [&](double ax, double ay, double az) {
+            return std::abs(ax) * extent.x + std::abs(ay) * extent.y + std::abs(az) * extent.z;
+        };
+        auto length = [](const Vec3_t& v) { return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z); };
+        Bounds_t b;
+        b.center = ApplyModelTransform(m, center);
+        b.extent = {reach(m.x_axis.x, m.y_axis.x, m.z_axis.x),
+                    reach(m.x_axis.y, m.y_axis.y, m.z_axis.y),
+                    reach(m.x_axis.z, m.y_axis.z, m.z_axis.z)};
+        b.radius = radius * std::max({length(m.x_axis), length(m.y_axis), length(m.z_axis)});
+        return b;
+    }
+};
+
+struct SceneMesh {
+    Vec3Buffer verts;
+    TriangleBuffer tris;
+    MeshTopology topo;
+    MeshNormals normals;
+    Bounds_t bounds; // local space
+};
+
+// Whether every component of `m` is finite and its translation inside
+// EngineBounds
+inline bool ModelTransformValid(const ModelTransform_t& m) {
+    auto finite = [](const Vec3_t& v) {
+        return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z);
+    };
+    return finite(m.x_axis) && finite(m.y_axis) && finite(m.z_axis) &&
+           CoordinateValid(m.position.x, MAX_X_COORDINATE) &&
+           CoordinateValid(m.position.y, MAX_Y_COORDINATE) &&
+           CoordinateValid(m.position.z, MAX_Z_COORDINATE);
+}
+
+struct SceneInstance {
+    uint32_t mesh;
+    ModelTransform_t transform;
+    Bounds_t bounds; // world space
+    uint64_t moved = 0; // pose revision of the last SetTransform
+};
+
+class SceneGraph {
+public:
+    using MeshId = uint32_t;
+    using InstanceId = uint32_t;
+
+    // Meshes and transforms are validated here, once, rather than in the
+    // per-frame math (see Validation.hpp)
+    MeshId AddMesh(Vec3Buffer verts, TriangleBuffer tris) {
+        BOUNDARY_CHECK(ValidateVertices(verts, "SCENE: AddMesh"), "SCENE: invalid mesh vertices");
+        SceneMesh& mesh = meshes_.emplace_back();
+        mesh.verts = std::move(verts);
+        mesh.tris = std::move(tris);
+        mesh.topo.Update(mesh.tris);
+        mesh.normals.Update(mesh.verts, mesh.tris);
+        mesh.bounds = Bounds_t::Of(mesh.verts);
+        revision_ = NextBufferRevision();
+        return static_cast<MeshId>(meshes_.size() - 1);
+    }
+
+    InstanceId AddInstance(MeshId mesh, const ModelTransform_t& transform = {}) {
+        BOUNDARY_CHECK(mesh < meshes_.size(), "SCENE: unknown mesh");
+        BOUNDARY_CHECK(ModelTransformValid(transform), "SCENE: invalid transform");
+        instances_.push_back({mesh, transform, meshes_[mesh].bounds.Transformed(transform)});
+        revision_ = NextBufferRevision();
+        return static_cast<InstanceId>(instances_.size() - 1);
+    }
+
+    // Moving an instance does not change the batch layout, so it keeps the
+    // scene revision and only bumps the pose revision
+    void SetTransform(InstanceId id, const ModelTransform_t& transform) {
+        BOUNDARY_CHECK(id < instances_.size(), "SCENE: unknown instance");
+        BOUNDARY_CHECK(ModelTransformValid(transform), "SCENE: invalid transform");
+        SceneInstance& instance = instances_[id];
+        instance.transform = transform;
+        instance.bounds = meshes_[instance.mesh].bounds.Transformed(transform);
+        pose_revision_ = instance.moved = NextBufferRevision();
+    }
+
+    inline const SceneMesh& mesh(MeshId id) const { return meshes_[id]; }
+    inline const SceneInstance& instance(InstanceId id) const { return instances_[id]; }
+    inline size_t mesh_count() const { return meshes_.size(); }
+    inline size_t instance_count() const { return instances_.size(); }
+
+    // Changes whenever a mesh or instance is added
+    inline uint64_t revision() const { return revision_; }
+
+    // Changes whenever an instance moves
+    inline uint64_t pose_revision() const { return pose_revision_; }
+
+private:
+    std::vector<SceneMesh> meshes_;
+    std::vector<SceneInstance> instances_;
+    uint64_t revision_ = NextBufferRevision();
+    uint64_t pose_revision_ = 0;
+};
+
+// Projected-space bounds and nearest depth of a visible instance's box;
+// z_near is 0 (never occluded) when the box reaches behind the near plane
+struct InstanceCoverage_t {
+    Vec2_t proj_min, proj_max;
+    double z_near;
+};
+
+// Pixel rectangle that can hold an instance's samples and outline
+inline PixelRect_t CoverageRect(const InstanceCoverage_t& c, int width, int height) {
+    // One pixel of margin covers rounding between the box corners and the
+    // vertex cache
+    const PixelRect_t r = {
+        static_cast<int>(std::floor((c.proj_min.x + 1.0) * 0.5 * width)) - 1,
+        static_cast<int>(std::floor((1.0 - (c.proj_max.y + 1.0) * 0.5) * height)) - 1,
+        static_cast<int>(std::ceil((c.proj_max.x + 1.0) * 0.5 * width)) + 1,
+        static_cast<int>(std::ceil((1.0 - (c.proj_min.y + 1.0) * 0.5) * height)) + 1};
+    return r.Intersect({0, 0, width - 1, height - 1});
+}
+
+// What a batch last drew into its frame; `rects` is indexed by instance id
+// and holds an empty rectangle for instances that were not drawn
+struct SceneDrawnState {
+    bool valid = false;
+    Vec3_t eye = {0.0, 0.0, 0.0};
+    Vec3_t target = {0.0, 0.0, 0.0};
+    int width = 0;
+    int height = 0;
+    uint64_t scene_revision = 0;
+    uint64_t pose_revision = 0;
+    std::vector<PixelRect_t> rects;
+};
+
+// Output of BuildSceneBatch; keep it alive across frames so the caches and
+// index lists are reused
+struct SceneBatch {
+    bool front_to_back = false;  // draw nearer instances first
+    bool lit = false;            // light vertices into xf.light
+    Lighting lighting;
+
+    TransformedVertices xf;
+    TriangleBuffer tris;           // indices into xf
+    std::vector<Edge> edges;       // indices into xf
+    std::vector<uint32_t> visible; // instance ids, in scene order
+    std::vector<uint32_t> first;   // first xf vertex of each visible instance
+    std::vector<uint32_t> first_tri; // first triangle of each visible instance
+    std::vector<uint32_t> first_edge; // first edge of each visible instance
+    std::vector<InstanceCoverage_t> coverage; // per visible instance
+    std::vector<uint8_t> facing;   // per triangle, 1 if it faces the eye
+    std::vector<uint32_t> draw_order; // visible slots, nearest first if front_to_back
+    std::vector<uint32_t> tri_order;  // triangles in draw order (front_to_back only)
+    size_t culled = 0;   // rejected by the frustum
+    size_t occluded = 0; // rejected by the depth pyramid in the last fill
+
+    uint64_t scene_revision = 0; // scene layout the index lists were built for
+    std::vector<uint32_t> candidates; // scratch for the visibility pass
+
+    // Camera (and lighting) the cache was last transformed with, and each
+    // visible slot's pose revision at the time; unchanged slots are not
+    // transformed again
+    Vec3_t xf_eye = {0.0, 0.0, 0.0};
+    Vec3_t xf_target = {0.0, 0.0, 0.0};
+    double xf_aspect = 0.0;
+    bool xf_lit = false;
+    Lighting xf_lighting;
+    std::vector<uint64_t> xf_moved;
+
+    SceneDrawnState drawn; // kept by incremental renders only
+};
+
+inline bool InstanceVisible(const Frustum_t& frustum, const SceneInstance& instance) {
+    const Bounds_t& b = instance.bounds;
+    return frustum.IntersectsSphere(b.center, b.radius) &&
+           frustum.IntersectsBox(b.center, b.extent);
+}
+
+// Bounds of a world-space box on screen, from its eight corners
+inline InstanceCoverage_t InstanceCoverage(const TransformedVertices& xf,
+                                           const Vec3_t& eye,
+                                           const Bounds_t& b) {
+    InstanceCoverage_t c = {{HUGE_VAL, HUGE_VAL}, {-HUGE_VAL, -HUGE_VAL}, HUGE_VAL};
+    for (int corner = 0; corner < 8; ++corner) {
+        const Vec3_t r = {b.center.x + ((corner & 1) ? b.extent.x : -b.extent.x) - eye.x,
+                          b.center.y + ((corner & 2) ? b.extent.y : -b.extent.y) - eye.y,
+                          b.center.z + ((corner & 4) ? b.extent.z : -b.extent.z) - eye.z};
+        const double cz = VecDotAtomic(r, xf.view.forward);
+        if (cz < CameraSettings::near_plane) return {{-1.0, -1.0}, {1.0, 1.0}, 0.0};
+        const double px = VecDotAtomic(r, xf.view.right) / cz * xf.focal_x;
+        const double py = VecDotAtomic(r, xf.view.up) / cz * xf.focal_y;
+        c.proj_min = {std::min(c.proj_min.x, px), std::min(c.proj_min.y, py)};
+        c.proj_max = {std::max(c.proj_max.x, px), std::max(c.proj_max.y, py)};
+        c.z_near = std::min(c.z_near, cz);
+    }
+    return c;
+}
+
+inline void BuildSceneBatch(const SceneGraph& scene,
+                            const Vec3_t& eye,
+                            const Vec3_t& target,
+                            SceneBatch& batch,
+                            double aspect_ratio = CameraSettings::aspect_ratio) {
+    TransformedVertices& xf = batch.xf;
+    xf.view = LookAt(eye, target, CAMERA_UP);
+    const double focal = CameraSettings::FovToFocalLength(CameraSettings::camera_fov);
+    const Frustum_t frustum = BuildFrustum(xf.view, eye, focal, aspect_ratio);
+    xf.SetProjection(focal, aspect_ratio);
+
+    batch.candidates.clear();
+    for (uint32_t id = 0; id < scene.instance_count(); ++id)
+        if (InstanceVisible(frustum, scene.instance(id)))
+            batch.candidates.push_back(id);
+    batch.culled = scene.instance_count() - batch.candidates.size();
+
+    // Index lists depend only on which instances are drawn
+    const bool same_camera = batch.xf_eye == eye && batch.xf_target == target &&
+                             batch.xf_aspect == aspect_ratio && batch.xf_lit == batch.lit &&
+                             (!batch.lit || batch.xf_lighting == batch.lighting);
+    bool retransform_all = !same_camera;
+    if (batch.candidates != batch.visible || batch.scene_revision != scene.revision()) {
+        retransform_all = true;
+        batch.visible.swap(batch.candidates);
+        batch.scene_revision = scene.revision();
+        batch.first.clear();
+        batch.first_tri.clear();
+        batch.first_edge.clear();
+        batch.tris.indices.clear();
+        batch.edges.clear();
+        size_t base = 0;
+        for (uint32_t id : batch.visible) {
+            const SceneMesh& mesh = scene.mesh(scene.instance(id).mesh);
+            batch.first.push_back(static_cast<uint32_t>(base));
+            batch.first_tri.push_back(static_cast<uint32_t>(batch.tris.size()));
+            batch.first_edge.push_back(static_cast<uint32_t>(batch.edges.size()));
+            for (const auto& tri : mesh.tris.indices)
+                batch.tris.indices.push_back({static_cast<uint32_t>(tri[0] + base),
+                                              static_cast<uint32_t>(tri[1] + base),
+                                              static_cast<uint32_t>(tri[2] + base)});
+            for (const Edge& e : mesh.topo.edges)
+                batch.edges.emplace_back(e.a + base, e.b + base);
+            base += mesh.verts.size();
+            BOUNDARY_CHECK(base <= UINT32_MAX, "SCENE: batch exceeds 32-bit indices");
+        }
+        batch.first.push_back(static_cast<uint32_t>(base));
+        batch.first_tri.push_back(static_cast<uint32_t>(batch.tris.size()));
+        batch.first_edge.push_back(static_cast<uint32_t>(batch.edges.size()));
+        batch.tris.touch();
+    }
+
+    if (retransform_all) {
+        batch.xf_eye = eye;
+        batch.xf_target = target;
+        batch.xf_aspect = aspect_ratio;
+        batch.xf_lit = batch.lit;
+        batch.xf_lighting = batch.lighting;
+        batch.xf_moved.assign(batch.visible.size(), UINT64_MAX);
+    }
+
+    const size_t total = batch.first.back();
+    xf.cam.resize(total);
+    xf.proj.resize(total);
+    if (batch.lit) xf.light.resize(total);
+    else xf.light.clear();
+    batch.facing.resize(batch.tris.size());
+    batch.coverage.resize(batch.visible.size());
+    for (size_t k = 0; k < batch.visible.size(); ++k) {
+        const SceneInstance& instance = scene.instance(batch.visible[k]);
+        if (batch.xf_moved[k] == instance.moved) continue;
+        batch.xf_moved[k] = instance.moved;
+        const SceneMesh& mesh = scene.mesh(instance.mesh);
+        const Vec3Buffer& verts = mesh.verts;
+        TransformInstanceToScreenBatch(verts, instance.transform, xf.view, eye, focal,
+                                       aspect_ratio, xf.cam, xf.proj,
+                                       0, verts.size(), batch.first[k]);
+        batch.coverage[k] = InstanceCoverage(xf, eye, instance.bounds);
+        FacingMask(mesh.normals, InverseModelTransform(instance.transform, eye), batch.facing,
+                   0, mesh.tris.size(), batch.first_tri[k],
+                   ModelDeterminant(instance.transform) < 0.0);
+        if (batch.lit)
+            LightVertices(mesh.normals.vertex,
+                          ModelLightDirection(instance.transform, batch.lighting.direction),
+                          batch.lighting.ambient, xf.light, 0, verts.size(), batch.first[k]);
+    }
+
+    batch.draw_order.resize(batch.visible.size());
+    for (uint32_t k = 0; k < batch.draw_order.size(); ++k) batch.draw_order[k] = k;
+    batch.tri_order.clear();
+    if (batch.front_to_back) {
+        // Unclipped instances by nearest depth; ones reaching past the near
+        // plane (z_near 0) first, as they are nearest of all
+        std::stable_sort(batch.draw_order.begin(), batch.draw_order.end(),
+                         [&](uint32_t l, uint32_t r) {
+                             return batch.coverage[l].z_near < batch.coverage[r].z_near;
+                         });
+        batch.tri_order.reserve(batch.tris.size());
+        for (uint32_t k : batch.draw_order)
+            for (uint32_t t = batch.first_tri[k]; t < batch.first_tri[k + 1]; ++t)
+                batch.tri_order.push_back(t);
+    }
+}
+
+// Fill pass over a batch: instances in draw order, each skipped when its
+// screen bounds are hidden behind what is already in the depth pyramid.
+// Only pixels inside `scissor` are written; instances entirely outside it
+// are skipped without counting as occluded. Back faces are culled with the
+// batch's facing flags.
+template <typename Format>
+inline void RenderSceneFilled(SceneBatch& batch,
+                              Frame& fb,
+                              DepthSurface<Format>& zbuf,
+                              const PixelRect_t& scissor,
+                              const FillStyle& style = {}) {
+    batch.occluded = 0;
+    if (fb.empty() || scissor.empty()) return;
+    const std::span<const std::array<uint32_t, 3>> tris(batch.tris.indices);
+    FillStyle instance_style = style;
+    for (uint32_t k : batch.draw_order) {
+        const InstanceCoverage_t& c = batch.coverage[k];
+        if (c.z_near > 0.0) {
+            const PixelRect_t r = CoverageRect(c, fb.width(), fb.height());
+            if (!r.empty() && !r.Overlaps(scissor)) continue;
+            const PixelRect_t visible = r.Intersect(scissor);
+            if (r.empty() ||
+                zbuf.Occluded(visible.x0, visible.y0, visible.x1, visible.y1,
+                              Format::Nearer(c.z_near))) {
+                ++batch.occluded;
+                continue;
+            }
+        }
+        const size_t first = batch.first_tri[k], count = batch.first_tri[k + 1] - first;
+        instance_style.facing = std::span<const uint8_t>(batch.facing).subspan(first, count);
+        FillTriangles(batch.xf, tris.subspan(first, count), fb, zbuf, scissor, instance_style);
+        if (batch.front_to_back && c.z_near > 0.0)
+            zbuf.RefreshTileBounds(CoverageRect(c, fb.width(), fb.height()).Intersect(scissor));
+    }
+}
+
+template <typename Format>
+inline void RenderSceneFilled(SceneBatch& batch,
+                              Frame& fb,
+                              DepthSurface<Format>& zbuf,
+                              const FillStyle& style = {}) {
+    RenderSceneFilled(batch, fb, zbuf, fb.bounds(), style);
+}
+
+// `style` with the batch's facing flags, for fill passes over all of
+// `batch.tris` at once (the parallel rasterizer)
+inline FillStyle SceneFillStyle(const SceneBatch& batch, FillStyle style) {
+    style.facing = batch.facing;
+    return style;
+}
+
+// Whether the frame `batch` last drew (with the same camera and frame size)
+// can be patched rather than redrawn
+inline bool SceneDrawnReusable(const SceneGraph& scene, const SceneBatch& batch,
+                               const Vec3_t& eye, const Vec3_t& target,
+                               int width, int height) {
+    const SceneDrawnState& d = batch.drawn;
+    return d.valid && d.eye == eye && d.target == target &&
+           d.width == width && d.height == height &&
+           d.scene_revision == scene.revision();
+}
+
+// Screen area that changed since `batch` was last drawn from the same
+// camera: where each instance moved since then was, and now is. Call after
+// BuildSceneBatch, and only when SceneDrawnReusable.
+inline void SceneDamage(const SceneGraph& scene, const SceneBatch& batch,
+                        int width, int height, DamageRegion& damage) {
+    damage.Clear();
+    const SceneDrawnState& d = batch.drawn;
+    if (scene.pose_revision() <= d.pose_revision) return;
+    for (uint32_t id = 0; id < scene.instance_count(); ++id)
+        if (scene.instance(id).moved > d.pose_revision)
+            damage.Add(d.rects[id]);
+    for (size_t k = 0; k < batch.visible.size(); ++k)
+        if (scene.instance(batch.visible[k]).moved > d.pose_revision)
+            damage.Add(CoverageRect(batch.coverage[k], width, height));
+}
+
+// Records what was just drawn from the batch, for the next SceneDamage
+inline void NoteSceneDrawn(const SceneGraph& scene, SceneBatch& batch,
+                           const Vec3_t& eye, const Vec3_t& target,
+                           int width, int height) {
+    SceneDrawnState& d = batch.drawn;
+    d.valid = true;
+    d.eye = eye;
+    d.target = target;
+    d.width = width;
+    d.height = height;
+    d.scene_revision = scene.revision();
+    d.pose_revision = scene.pose_revision();
+    d.rects.assign(scene.instance_count(), PixelRect_t{});
+    for (size_t k = 0; k < batch.visible.size(); ++k)
+        d.rects[batch.visible[k]] = CoverageRect(batch.coverage[k], width, height);
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include "DataTypes.hpp"
+#include "MeshNormals.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// ─────────────────────────────────────────────
+// Lambertian ASCII shading
+// ─────────────────────────────────────────────
+//
+// Lighting is evaluated once per vertex, right after the transform stage,
+// into an 8-bit luminance lane next to the vertex cache. The fill pass maps
+// luminance to glyphs through a 256-entry lookup table: once per triangle
+// (flat) or per pixel from a luminance plane set up with the depth plane
+// (Gouraud). Either way the raster loop never touches a normal or a light.
+
+inline constexpr std::string_view SHADE_RAMP = " .:-=+*#%@";
+
+enum class ShadeMode : uint8_t {
+    Solid,   // every pixel gets the fill character
+    Flat,    // one glyph per triangle, from its vertices' mean luminance
+    Gouraud  // luminance interpolated across the triangle
+};
+
+// Luminance (0-255) to glyph, darkest first. The blank first glyph is
+// skipped for lit surfaces, so a face turned from the light still reads
+// as solid rather than vanishing into the background.
+class GlyphRamp {
+public:
+    explicit GlyphRamp(std::string_view ramp = SHADE_RAMP) {
+        const size_t first = ramp.size() > 1 && ramp.front() == ' ' ? 1 : 0;
+        const size_t steps = ramp.size() - first;
+        for (int l = 0; l < 256; ++l)
+            lut_[l] = steps == 0 ? '#' : ramp[first + std::min(steps - 1, l * steps / 256)];
+    }
+
+    inline char operator[](uint8_t luminance) const { return lut_[luminance]; }
+    inline const char* data() const { return lut_; }
+
+private:
+    char lut_[256];
+};
+
+// A directional light; `direction` points from the surface towards the
+// light and must be unit length
+struct Lighting {
+    Vec3_t direction = {-0.408248, 0.816497, 0.408248}; // (-1, 2, 1) / sqrt(6)
+    double ambient = 0.1;
+
+    bool operator==(const Lighting&) const = default;
+};
+
+// Lambert term of each unit normal in [begin, end) into `out[dst + i -
+// begin]`: ambient + (1 - ambient) * max(0, n . L), scaled to 0-255.
+// `direction` is the light in the normals' own space; normals point out of
+// the front side (MeshNormals::vertex).
+inline void LightVertices(const Vec3Buffer& normals,
+                          const Vec3_t& direction,
+                          double ambient,
+                          std::span<uint8_t> out,
+                          size_t begin, size_t end, size_t dst) {
+    const double diffuse = (1.0 - ambient) * 255.0;
+    const double base = ambient * 255.0 + 0.5;
+    const double* nx = normals.x().data();
+    const double* ny = normals.y().data();
+    const double* nz = normals.z().data();
+    uint8_t* o = out.data() + dst;
+    for (size_t i = begin; i < end; ++i) {
+        const double lambert = std::max(0.0, nx[i] * direction.x + ny[i] * direction.y + nz[i] * direction.z);
+        o[i - begin] = static_cast<uint8_t>(std::min(255.0, base + diffuse * lambert));
+    }
+}
+
+// Per triangle in [begin, end): 1 if it faces `eye` (in the mesh's own
+// space), written to `out[dst + t - begin]`. `mirrored` flips the test for
+// meshes placed by a transform with a negative determinant.
+inline void FacingMask(const MeshNormals& normals,
+                       const Vec3_t& eye,
+                       std::span<uint8_t> out,
+                       size_t begin, size_t end, size_t dst,
+                       bool mirrored = false) {
+    const double* nx = normals.face.x().data();
+    const double* ny = normals.face.y().data();
+    const double* nz = normals.face.z().data();
+    const double* d = normals.face_d.data();
+    uint8_t* o = out.data() + dst;
+    for (size_t t = begin; t < end; ++t)
+        o[t - begin] = (nx[t] * eye.x + ny[t] * eye.y + nz[t] * eye.z < d[t]) != mirrored;
+}
+
+// Shading state for one mesh drawn straight from its own vertex buffer (no
+// instance transform): facing flags for the current eye, and vertex light
+// recomputed only when the normals or the lighting change. Keep it alive
+// across frames next to the vertex cache whose `light` lane it fills.
+struct MeshShading {
+    std::vector<uint8_t> facing; // per triangle
+
+    void Update(const MeshNormals& normals, const Vec3_t& eye,
+                const Lighting* lighting, std::vector<uint8_t>& light) {
+        facing.resize(normals.face_d.size());
+        FacingMask(normals, eye, facing, 0, facing.size(), 0);
+        if (!lighting) {
+            light.clear();
+            lit_revision_ = 0;
+            return;
+        }
+        if (lit_revision_ == normals.vertex.revision && lit_with_ == *lighting &&
+            light.size() == normals.vertex.size())
+            return;
+        light.resize(normals.vertex.size());
+        LightVertices(normals.vertex, lighting->direction, lighting->ambient, light,
+                      0, light.size(), 0);
+        lit_revision_ = normals.vertex.revision;
+        lit_with_ = *lighting;
+    }
+
+private:
+    uint64_t lit_revision_ = 0;
+    Lighting lit_with_;
+};
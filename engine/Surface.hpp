@@ -0,0 +1,395 @@
+#pragma once
+#include "AlignedLanes.hpp"
+#include "CameraSettings.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Inclusive pixel rectangle; empty when x0 > x1 or y0 > y1
+struct PixelRect_t {
+    int x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+
+    inline bool empty() const { return x0 > x1 || y0 > y1; }
+
+    inline bool Overlaps(const PixelRect_t& o) const {
+        return x0 <= o.x1 && o.x0 <= x1 && y0 <= o.y1 && o.y0 <= y1;
+    }
+
+    inline PixelRect_t Intersect(const PixelRect_t& o) const {
+        return {std::max(x0, o.x0), std::max(y0, o.y0), std::min(x1, o.x1), std::min(y1, o.y1)};
+    }
+
+    // Smallest rectangle holding both; an empty side is ignored
+    inline PixelRect_t Union(const PixelRect_t& o) const {
+        if (empty()) return o;
+        if (o.empty()) return *this;
+        return {std::min(x0, o.x0), std::min(y0, o.y0), std::max(x1, o.x1), std::max(y1, o.y1)};
+    }
+
+    bool operator==(const PixelRect_t&) const = default;
+};
+
+// Screen area to redraw, as a few disjoint rectangles. Overlapping
+// rectangles are merged as they are added; past MAX_RECTS the region
+// collapses to its bounding box, since each rectangle costs a pass.
+struct DamageRegion {
+    static constexpr size_t MAX_RECTS = 8;
+
+    std::vector<PixelRect_t> rects;
+
+    inline bool empty() const { return rects.empty(); }
+    inline void Clear() { rects.clear(); }
+
+    void Add(PixelRect_t r) {
+        if (r.empty()) return;
+        // A merged rectangle can reach others, so keep merging until none do
+        for (size_t i = 0; i < rects.size();) {
+            if (rects[i].Overlaps(r)) {
+                r = r.Union(rects[i]);
+                rects[i] = rects.back();
+                rects.pop_back();
+                i = 0;
+            } else {
+                ++i;
+            }
+        }
+        rects.push_back(r);
+        if (rects.size() > MAX_RECTS) {
+            PixelRect_t all;
+            for (const PixelRect_t& rect : rects) all = all.Union(rect);
+            rects.assign(1, all);
+        }
+    }
+
+    inline size_t area() const {
+        size_t total = 0;
+        for (const PixelRect_t& r : rects)
+            total += static_cast<size_t>(r.x1 - r.x0 + 1) * (r.y1 - r.y0 + 1);
+        return total;
+    }
+};
+
+// ─────────────────────────────────────────────
+// Runtime-sized 2D surface
+// ─────────────────────────────────────────────
+//
+// One aligned heap allocation; rows are `pitch()` elements apart, with the
+// pitch padded to a whole cache line so every row starts aligned. fb[y][x]
+// indexing works the same as on the old fixed-size arrays.
+//
+// Resize() only reallocates when the new size needs more storage than the
+// current allocation; contents are unspecified after a resize.
+
+template <typename T>
+class Surface {
+    static_assert(std::is_trivially_copyable_v<T>, "Surface holds raw pixel data");
+
+public:
+    Surface() = default;
+
+    Surface(int width, int height) { Resize(width, height); }
+
+    Surface(Surface&& other) noexcept { Swap(other); }
+
+    Surface& operator=(Surface&& other) noexcept {
+        if (this != &other) {
+            Release();
+            Swap(other);
+        }
+        return *this;
+    }
+
+    Surface(const Surface&) = delete;
+    Surface& operator=(const Surface&) = delete;
+
+    ~Surface() { Release(); }
+
+    // Returns true if the dimensions changed
+    bool Resize(int width, int height) {
+        width = std::max(width, 0);
+        height = std::max(height, 0);
+        if (width == width_ && height == height_) return false;
+
+        constexpr size_t per_line = std::max<size_t>(1, SOA_ALIGNMENT / sizeof(T));
+        const size_t pitch = (static_cast<size_t>(width) + per_line - 1) / per_line * per_line;
+        const size_t needed = pitch * static_cast<size_t>(height);
+        if (needed > capacity_) {
+            Release();
+            data_ = static_cast<T*>(::operator new(needed * sizeof(T),
+                                                   std::align_val_t{SOA_ALIGNMENT}));
+            capacity_ = needed;
+        }
+        width_ = width;
+        height_ = height;
+        pitch_ = pitch;
+        return true;
+    }
+
+    inline int width() const { return width_; }
+    inline int height() const { return height_; }
+    inline size_t pitch() const { return pitch_; }
+    inline bool empty() const { return width_ == 0 || height_ == 0; }
+
+    inline double aspect_ratio() const {
+        return height_ > 0 ? static_cast<double>(width_) / height_ : CameraSettings::aspect_ratio;
+    }
+
+    inline T* operator[](int y) { return data_ + static_cast<size_t>(y) * pitch_; }
+    inline const T* operator[](int y) const { return data_ + static_cast<size_t>(y) * pitch_; }
+
+    inline T* data() { return data_; }
+    inline const T* data() const { return data_; }
+
+    // Whole allocation in use, including row padding
+    inline size_t size_with_padding() const { return pitch_ * static_cast<size_t>(height_); }
+
+    inline PixelRect_t bounds() const { return {0, 0, width_ - 1, height_ - 1}; }
+
+    void Fill(T value) {
+        std::fill_n(data_, size_with_padding(), value);
+    }
+
+    // `r` must lie inside the surface
+    void FillRect(const PixelRect_t& r, T value) {
+        if (r.empty()) return;
+        for (int y = r.y0; y <= r.y1; ++y)
+            std::fill((*this)[y] + r.x0, (*this)[y] + r.x1 + 1, value);
+    }
+
+private:
+    void Swap(Surface& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(width_, other.width_);
+        std::swap(height_, other.height_);
+        std::swap(pitch_, other.pitch_);
+    }
+
+    void Release() {
+        if (data_)
+            ::operator delete(data_, std::align_val_t{SOA_ALIGNMENT});
+        data_ = nullptr;
+        capacity_ = 0;
+    }
+
+    T* data_ = nullptr;
+    size_t capacity_ = 0; // elements
+    int width_ = 0;
+    int height_ = 0;
+    size_t pitch_ = 0;    // elements per row
+};
+
+using Frame = Surface<char>;
+
+// ─────────────────────────────────────────────
+// Depth storage formats
+// ─────────────────────────────────────────────
+//
+// A format stores camera depth in its own type and knows how far a stored
+// value may be from the depth it was written for. The rasterizer works in
+// 1/z, so Passes() tests a new sample against a stored value without the
+// divide; Store() is only called for samples that pass.
+//
+// Nearer()/Further() widen a depth by the storage error, so bounds kept in
+// full precision still hold for what is actually stored.
+
+struct DepthF64 {
+    using storage = double;
+    static inline bool Passes(double inv_z, storage d) { return inv_z * d > 1.0; }
+    static inline storage Store(double z) { return z; }
+    static inline double Load(storage d) { return d; }
+    static inline double Nearer(double z) { return z * (1.0 - 1e-9); }
+    static inline double Further(double z) { return z * (1.0 + 1e-9); }
+};
+
+struct DepthF32 {
+    using storage = float;
+    static inline bool Passes(double inv_z, storage d) { return inv_z * d > 1.0; }
+    static inline storage Store(double z) { return static_cast<float>(z); }
+    static inline double Load(storage d) { return d; }
+    static inline double Nearer(double z) { return z * (1.0 - 1e-6); }
+    static inline double Further(double z) { return z * (1.0 + 1e-6); }
+};
+
+// Linear depth over [0, far_plane] in 16 bits; depths past the far plane
+// saturate. Steps are far_plane / 65535, about a thousandth of a unit.
+struct DepthUnorm16 {
+    using storage = uint16_t;
+    static constexpr double scale = 65535.0 / CameraSettings::far_plane;
+    static constexpr double quantum = 1.0 / scale;
+    static inline bool Passes(double inv_z, storage d) { return inv_z * d > scale; }
+    static inline storage Store(double z) {
+        return static_cast<storage>(std::min(z * scale + 0.5, 65535.0));
+    }
+    static inline double Load(storage d) { return d * quantum; }
+    static inline double Nearer(double z) { return z * (1.0 - 1e-9) - quantum; }
+    static inline double Further(double z) { return z * (1.0 + 1e-9) + quantum; }
+};
+
+// Build with -DDEPTH_FORMAT=DepthF64 (or DepthUnorm16) to change the depth
+// buffer every renderer uses
+#ifndef DEPTH_FORMAT
+#define DEPTH_FORMAT DepthF32
+#endif
+
+// ─────────────────────────────────────────────
+// Depth buffer with a coarse depth pyramid
+// ─────────────────────────────────────────────
+//
+// Next to the per-pixel depths, every HIZ_TILE x HIZ_TILE tile keeps a lower
+// bound on its nearest depth and an upper bound on its furthest, both in
+// full precision. The rasterizer rejects a triangle whose nearest depth is
+// behind the furthest depth of every tile it touches, and tightens the
+// bounds as it writes.
+//
+// Fill() only resets the bounds and bumps a frame epoch; a tile's pixels
+// are cleared when the rasterizer first touches it (Prepare), so tiles
+// nothing is drawn into are never written. Read pixels back with Depth(),
+// which accounts for tiles that are still stale. ClearRect() resets part of
+// the buffer for a partial redraw and loosens the bounds of the tiles it
+// touches. Pixels written outside the rasterizer are not tracked.
+
+template <typename Format>
+class DepthSurface : public Surface<typename Format::storage> {
+    using Base = Surface<typename Format::storage>;
+
+public:
+    using format = Format;
+    static constexpr int HIZ_TILE = 8;
+
+    DepthSurface() = default;
+
+    DepthSurface(int width, int height) { Resize(width, height); }
+
+    // Contents are unspecified after a resize; the pyramid rejects nothing
+    // until the next Fill()
+    bool Resize(int width, int height) {
+        if (!Base::Resize(width, height)) return false;
+        tiles_x_ = (this->width() + HIZ_TILE - 1) / HIZ_TILE;
+        tiles_y_ = (this->height() + HIZ_TILE - 1) / HIZ_TILE;
+        const size_t tiles = static_cast<size_t>(tiles_x_) * tiles_y_;
+        tile_min_.assign(tiles, 0.0);
+        tile_max_.assign(tiles, std::numeric_limits<double>::infinity());
+        // Live until the next Fill(): unspecified contents stay as they are
+        tile_epoch_.assign(tiles, epoch_);
+        return true;
+    }
+
+    void Fill(double depth) {
+        if (++epoch_ == 0) {
+            // Wrapped: every tag is now ambiguous, so clear for real
+            epoch_ = 1;
+            Base::Fill(Format::Store(depth));
+            std::fill(tile_epoch_.begin(), tile_epoch_.end(), epoch_);
+        }
+        clear_ = Format::Store(depth);
+        std::fill(tile_min_.begin(), tile_min_.end(), Format::Nearer(depth));
+        std::fill(tile_max_.begin(), tile_max_.end(), Format::Further(depth));
+    }
+
+    // `r` must lie inside the buffer
+    void ClearRect(const PixelRect_t& r, double depth) {
+        if (r.empty()) return;
+        const typename Format::storage value = Format::Store(depth);
+        for (int ty = r.y0 / HIZ_TILE; ty <= r.y1 / HIZ_TILE; ++ty)
+            for (int tx = r.x0 / HIZ_TILE; tx <= r.x1 / HIZ_TILE; ++tx) {
+                Prepare(tx, ty);
+                int x0, y0, x1, y1;
+                TileBounds(tx, ty, x0, y0, x1, y1);
+                Base::FillRect(r.Intersect({x0, y0, x1, y1}), value);
+                double& near = tile_min_[ty * tiles_x_ + tx];
+                double& far = tile_max_[ty * tiles_x_ + tx];
+                near = std::min(near, Format::Nearer(depth));
+                far = std::max(far, Format::Further(depth));
+            }
+    }
+
+    // Clears a tile left stale by the last Fill(); call before touching its
+    // pixels
+    inline void Prepare(int tx, int ty) {
+        uint32_t& e = tile_epoch_[ty * tiles_x_ + tx];
+        if (e == epoch_) return;
+        e = epoch_;
+        int x0, y0, x1, y1;
+        TileBounds(tx, ty, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; ++y)
+            std::fill((*this)[y] + x0, (*this)[y] + x1 + 1, clear_);
+    }
+
+    // Camera depth at a pixel
+    inline double Depth(int x, int y) const {
+        const bool live = tile_epoch_[(y / HIZ_TILE) * tiles_x_ + x / HIZ_TILE] == epoch_;
+        return Format::Load(live ? (*this)[y][x] : clear_);
+    }
+
+    inline int tiles_x() const { return tiles_x_; }
+    inline int tiles_y() const { return tiles_y_; }
+    inline double tile_min(int tx, int ty) const { return tile_min_[ty * tiles_x_ + tx]; }
+    inline double tile_max(int tx, int ty) const { return tile_max_[ty * tiles_x_ + tx]; }
+
+    // Pixel rectangle of a tile, clipped to the buffer
+    inline void TileBounds(int tx, int ty, int& x0, int& y0, int& x1, int& y1) const {
+        x0 = tx * HIZ_TILE;
+        y0 = ty * HIZ_TILE;
+        x1 = std::min(x0 + HIZ_TILE, this->width()) - 1;
+        y1 = std::min(y0 + HIZ_TILE, this->height()) - 1;
+    }
+
+    // Some pixel of the tile was written at depth >= z
+    inline void NoteWrite(int tx, int ty, double z) {
+        double& m = tile_min_[ty * tiles_x_ + tx];
+        m = std::min(m, z);
+    }
+
+    // Every pixel of the tile was written at depth <= z (or was already nearer)
+    inline void CoverTile(int tx, int ty, double z) {
+        double& m = tile_max_[ty * tiles_x_ + tx];
+        m = std::min(m, z);
+    }
+
+    // Lowers the far bound of each tile overlapping `r` (inside the buffer)
+    // to the farthest depth stored in it. The rasterizer only tightens a
+    // bound when one triangle covers the whole tile; this catches tiles that
+    // many small triangles covered between them.
+    void RefreshTileBounds(const PixelRect_t& r) {
+        if (r.empty()) return;
+        for (int ty = r.y0 / HIZ_TILE; ty <= r.y1 / HIZ_TILE; ++ty)
+            for (int tx = r.x0 / HIZ_TILE; tx <= r.x1 / HIZ_TILE; ++tx) {
+                if (tile_epoch_[ty * tiles_x_ + tx] != epoch_) continue; // still clear
+                int x0, y0, x1, y1;
+                TileBounds(tx, ty, x0, y0, x1, y1);
+                double far = 0.0;
+                for (int y = y0; y <= y1; ++y)
+                    for (int x = x0; x <= x1; ++x)
+                        far = std::max(far, Format::Load((*this)[y][x]));
+                double& m = tile_max_[ty * tiles_x_ + tx];
+                m = std::min(m, Format::Further(far));
+            }
+    }
+
+    // True if nothing at depth >= z_near can pass the depth test anywhere in
+    // the inclusive pixel rectangle (which must lie inside the buffer)
+    bool Occluded(int x0, int y0, int x1, int y1, double z_near) const {
+        for (int ty = y0 / HIZ_TILE; ty <= y1 / HIZ_TILE; ++ty)
+            for (int tx = x0 / HIZ_TILE; tx <= x1 / HIZ_TILE; ++tx)
+                if (tile_max_[ty * tiles_x_ + tx] > z_near) return false;
+        return true;
+    }
+
+private:
+    std::vector<double> tile_min_;
+    std::vector<double> tile_max_;
+    std::vector<uint32_t> tile_epoch_;
+    uint32_t epoch_ = 0;
+    typename Format::storage clear_{};
+    int tiles_x_ = 0;
+    int tiles_y_ = 0;
+};
+
+using DepthBuffer = DepthSurface<DEPTH_FORMAT>;
@@ -1,12 +1,17 @@
 #pragma once
 #include "CameraSettings.hpp"
+#include "InputParser.hpp"
+#include "KeyMap.hpp"
 #include <termios.h>
 #include <unistd.h>
-#include <fcntl.h>
+#include <poll.h>
 #include <sys/ioctl.h>
+#include <cerrno>
 #include <csignal>
 #include <iostream>
-#include <unordered_map>
+#include <array>
+#include <bitset>
+#include <span>
 #include <string>
 
 namespace Terminal {
@@ -23,12 +28,17 @@ inline bool too_small = false;
 
 inline void UpdateTerminalSize() {
     struct winsize w;
-    ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
-    term_width = w.ws_col;
-    term_height = w.ws_row;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0 && w.ws_col > 0 && w.ws_row > 0) {
+        term_width = w.ws_col;
+        term_height = w.ws_row;
+    } else {
+        // Not a terminal: fall back to the default surface size
+        term_width = CameraSettings::screen_width;
+        term_height = CameraSettings::screen_height;
+    }
 
-    too_small = (term_width < CameraSettings::screen_width ||
-                 term_height < CameraSettings::screen_height);
+    too_small = (term_width < CameraSettings::min_screen_width ||
+                 term_height < CameraSettings::min_screen_height);
 }
 
 inline bool DidTerminalResize() {
@@ -44,58 +54,141 @@ inline bool DidTerminalResize() {
 
 inline struct termios original_termios;
 
-inline void InitTerminal() {
+// Mouse reporting: button presses and drags (1002), SGR coordinates (1006)
+inline constexpr const char* MOUSE_ON = "\033[?1002h\033[?1006h";
+inline constexpr const char* MOUSE_OFF = "\033[?1006l\033[?1002l";
+
+inline bool mouse_reporting = false;
+
+// Raw, unechoed input; with `mouse`, the terminal also reports clicks and
+// drags (holding Shift usually still selects text)
+inline void InitTerminal(bool mouse = true) {
     tcgetattr(STDIN_FILENO, &original_termios);
     struct termios raw = original_termios;
     raw.c_lflag &= ~(ICANON | ECHO);
     tcsetattr(STDIN_FILENO, TCSANOW, &raw);
-    std::cout << "\033[?25l\033[2J\033[H" << std::flush;
+    mouse_reporting = mouse;
+    std::cout << "\033[?25l\033[2J\033[H" << (mouse ? MOUSE_ON : "") << std::flush;
 }
 
 inline void RestoreTerminal() {
     tcsetattr(STDIN_FILENO, TCSANOW, &original_termios);
-    std::cout << "\033[?25h\n" << std::flush;
+    std::cout << (mouse_reporting ? MOUSE_OFF : "") << "\033[?25h\n" << std::flush;
 }
 
 // ─────────────────────────────────────────────
-// Non-blocking raw input
+// Input events and key state
 // ─────────────────────────────────────────────
-
-inline int ReadKeyRaw() {
-    int ch = -1;
-    int oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
-    ch = getchar();
-    fcntl(STDIN_FILENO, F_SETFL, oldf);
-    return ch;
+//
+// PollKeys() asks poll() whether stdin has anything; when it does not, that
+// one syscall is the whole cost of input for the frame. Otherwise whatever
+// is pending is read() in bulk into the InputParser ring and decoded. The
+// descriptor is never switched to O_NONBLOCK: it is usually the same open
+// file as stdout, which the presenter thread is writing to.
+//
+// Keys (bytes and decoded escape sequences) are down for the poll they
+// arrived in; mouse buttons stay down from press to release.
+
+inline std::bitset<Key::CODES> key_state;
+inline std::bitset<Key::CODES> key_prev;
+
+// Bits of key_state kept between polls
+inline const std::bitset<Key::CODES> held_keys = [] {
+    std::bitset<Key::CODES> held;
+    held.set(Key::MOUSE_LEFT).set(Key::MOUSE_MIDDLE).set(Key::MOUSE_RIGHT);
+    return held;
+}();
+
+struct MouseState {
+    int x = 0, y = 0;   // last reported cell
+    int dx = 0, dy = 0; // cells dragged this poll (motion with a button held)
+    int wheel = 0;      // notches this poll, positive away from the user
+};
+
+inline MouseState mouse;
+inline uint8_t modifiers = 0; // Mod:: bits seen this poll
+
+// Events of the last poll, in arrival order; the rest of a burst longer
+// than this still updates the state above
+inline std::array<InputEvent, 64> events;
+inline size_t event_count = 0;
+
+inline InputParser input;
+inline bool input_closed = false; // stdin hit end of file or an error
+
+inline std::span<const InputEvent> Events() { return {events.data(), event_count}; }
+
+inline void ApplyEvent(const InputEvent& e) {
+    if (event_count < events.size()) events[event_count++] = e;
+    modifiers |= e.mods;
+    switch (e.type) {
+    case InputType::Key:
+        key_state.set(e.code);
+        return;
+    case InputType::MousePress:
+    case InputType::MouseRelease:
+    case InputType::MouseMove:
+        if (e.type == InputType::MouseMove) {
+            mouse.dx += e.x - mouse.x;
+            mouse.dy += e.y - mouse.y;
+        }
+        mouse.x = e.x;
+        mouse.y = e.y;
+        if (e.code) key_state.set(e.code, e.type != InputType::MouseRelease);
+        return;
+    case InputType::Wheel:
+        mouse.wheel += e.code == Key::WHEEL_UP ? 1 : -1;
+        key_state.set(e.code);
+        return;
+    }
 }
 
-// ─────────────────────────────────────────────
-// Key state tracking
-// ─────────────────────────────────────────────
-
-inline std::unordered_map<int, bool> key_state;
-inline std::unordered_map<int, bool> key_prev;
+// Whether stdin has input within `timeout_ms` (0 = just check). Frame loops
+// can wait here instead of sleeping, so a key wakes them at once. Once
+// stdin is closed this only sleeps.
+inline bool WaitInput(int timeout_ms) {
+    pollfd fd = {STDIN_FILENO, POLLIN, 0};
+    return ::poll(&fd, input_closed ? 0 : 1, timeout_ms) > 0 && (fd.revents & (POLLIN | POLLHUP));
+}
 
 inline void PollKeys() {
     key_prev = key_state;
-    key_state.clear();
-    int ch;
-    while ((ch = ReadKeyRaw()) != -1) {
-        key_state[ch] = true;
+    key_state &= held_keys;
+    mouse.dx = mouse.dy = mouse.wheel = 0;
+    modifiers = 0;
+    event_count = 0;
+
+    bool got_input = false;
+    while (WaitInput(0)) {
+        const std::span<char> space = input.WriteSpace();
+        if (space.empty()) break;
+        const ssize_t n = ::read(STDIN_FILENO, space.data(), space.size());
+        if (n <= 0) {
+            input_closed = n == 0 || (errno != EINTR && errno != EAGAIN);
+            break;
+        }
+        input.Commit(static_cast<size_t>(n));
+        input.Parse(ApplyEvent);
+        got_input = true;
     }
+    // A trailing ESC waits one quiet poll for the rest of its sequence
+    if (!got_input) input.Idle(ApplyEvent);
+}
+
+inline bool KeyDown(const std::bitset<Key::CODES>& keys, int keycode) {
+    return keycode >= 0 && keycode < Key::CODES && keys[keycode];
 }
 
 inline bool IsKeyPressed(int keycode) {
-    return key_state.count(keycode) > 0;
+    return KeyDown(key_state, keycode);
 }
 
 inline bool WasKeyJustPressed(int keycode) {
-    return key_state[keycode] && !key_prev[keycode];
+    return KeyDown(key_state, keycode) && !KeyDown(key_prev, keycode);
 }
 
 inline bool WasKeyJustReleased(int keycode) {
-    return !key_state[keycode] && key_prev[keycode];
+    return !KeyDown(key_state, keycode) && KeyDown(key_prev, keycode);
 }
 
 // ─────────────────────────────────────────────
@@ -103,15 +196,19 @@ inline bool WasKeyJustReleased(int keycode) {
 // ─────────────────────────────────────────────
 
 inline std::string PrintableChar(int ch) {
+    static constexpr const char* EXTENDED[] = {
+        "UP", "DOWN", "RIGHT", "LEFT", "HOME", "END", "INS", "DEL", "PGUP", "PGDN",
+        "F1", "F2", "F3", "F4", "LMB", "MMB", "RMB", "WHEEL+", "WHEEL-"};
     if (ch >= 32 && ch < 127) return std::string(1, static_cast<char>(ch));
     if (ch == 27) return "ESC";
+    if (ch >= Key::ARROW_UP && ch <= Key::WHEEL_DOWN) return EXTENDED[ch - Key::ARROW_UP];
     return "0x" + std::to_string(ch);
 }
 
 inline void DumpKeyState() {
     std::cout << "[Keys Pressed]: ";
-    for (const auto& [code, down] : key_state)
-        if (down) std::cout << PrintableChar(code) << " ";
+    for (int code = 0; code < Key::CODES; ++code)
+        if (key_state[code]) std::cout << PrintableChar(code) << " ";
     std::cout << '\n';
 }
 
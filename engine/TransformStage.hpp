@@ -0,0 +1,60 @@
+#pragma once
+#include "DataTypes.hpp"
+#include "CameraMath.hpp"
+#include "CameraSettings.hpp"
+#include "VectorBatch.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// ─────────────────────────────────────────────
+// Per-frame vertex transform stage
+// ─────────────────────────────────────────────
+//
+// Every world-space vertex is transformed exactly once per frame into camera
+// space and projected space. The output lanes are indexed exactly like the
+// source Vec3Buffer, so the fill and outline passes read shared vertices by
+// index instead of re-transforming them per triangle / per edge.
+//
+// The cache is meant to live across frames: the lanes are resized in place,
+// so steady-state frames do no heap allocation here.
+
+struct TransformedVertices {
+    CameraView_t view{};
+    Vec3Buffer cam;   // camera space (z > 0 is in front of the eye)
+    Vec2Buffer proj;  // projected coordinates, only valid where cam.z > 0
+    double focal_x = 0.0, focal_y = 0.0; // projection scales behind `proj`
+    std::vector<uint8_t> light; // per-vertex luminance (Shading.hpp); empty when unlit
+
+    inline size_t size() const { return cam.size(); }
+
+    inline bool InFront(size_t i) const { return cam.z()[i] > 0.0; }
+
+    inline void SetProjection(double focal_length, double aspect_ratio) {
+        focal_x = (focal_length / aspect_ratio) * CameraSettings::pixel_aspect;
+        focal_y = focal_length;
+    }
+
+    // Subpixel screen position of a camera-space point in front of the eye
+    // (e.g. a clipped vertex); matches proj + MapToScreenSubpixel
+    inline Vec2_t ProjectSubpixel(const Vec3_t& c, int screen_width, int screen_height) const {
+        const double inv_z = 1.0 / c.z;
+        const double px = c.x * inv_z * focal_x;
+        const double py = c.y * inv_z * focal_y;
+        return {(px + 1.0) * 0.5 * screen_width, (1.0 - (py + 1.0) * 0.5) * screen_height};
+    }
+};
+
+// `world` may be a Vec3Buffer or a compact position buffer (CompactMesh.hpp)
+template <typename Positions>
+inline void TransformVertices(const Positions& world,
+                              const Vec3_t& eye,
+                              const Vec3_t& target,
+                              TransformedVertices& out,
+                              double aspect_ratio = CameraSettings::aspect_ratio) {
+    out.view = LookAt(eye, target, CAMERA_UP);
+    const double focal = CameraSettings::FovToFocalLength(CameraSettings::camera_fov);
+    out.SetProjection(focal, aspect_ratio);
+
+    TransformToScreenBatch(world, out.view, eye, focal, aspect_ratio, out.cam, out.proj);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// ─────────────────────────────────────────────
+// Lock-free single-producer / single-consumer triple buffer
+// ─────────────────────────────────────────────
+//
+// The producer always owns one slot (back), the consumer owns another
+// (front), and the third (middle) is exchanged atomically between them. A
+// publish that lands before the consumer picked up the previous one
+// replaces it, so a slow consumer only ever sees the newest frame and the
+// producer never waits.
+
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer side
+    inline T& back() { return slots_[back_]; }
+
+    // Hand the back slot to the consumer. Returns true if this replaced a
+    // published slot the consumer never picked up (i.e. a frame was dropped).
+    inline bool Publish() {
+        const uint8_t prev = middle_.exchange(static_cast<uint8_t>(back_ | FRESH),
+                                              std::memory_order_acq_rel);
+        back_ = prev & INDEX_MASK;
+        return (prev & FRESH) != 0;
+    }
+
+    // Consumer side: swap in the newest published slot. Returns false if
+    // nothing was published since the last call.
+    inline bool Acquire() {
+        if (!(middle_.load(std::memory_order_relaxed) & FRESH)) return false;
+        const uint8_t prev = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = prev & INDEX_MASK;
+        return true;
+    }
+
+    inline T& front() { return slots_[front_]; }
+    inline const T& front() const { return slots_[front_]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    T slots_[3];
+    alignas(64) uint8_t back_ = 0;
+    alignas(64) uint8_t front_ = 1;
+    alignas(64) std::atomic<uint8_t> middle_{2};
+};
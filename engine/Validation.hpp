@@ -0,0 +1,94 @@
+#pragma once
+#include "EngineBounds.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+// ─────────────────────────────────────────────
+// Tiered validation
+// ─────────────────────────────────────────────
+//
+// VALIDATION_LEVEL picks how much checking is compiled in, independent of
+// NDEBUG:
+//
+//   0  off
+//   1  boundaries (default): whole buffers are validated once, when they
+//      are loaded or handed to the engine, and per-call preconditions
+//      (ranges, ids) are checked; the math in between runs unchecked
+//   2  paranoid: additionally every atomic and indexed vector operation
+//      checks its inputs and result
+//
+// A failed check prints its message and aborts, like assert.
+
+#define VALIDATION_OFF 0
+#define VALIDATION_BOUNDARIES 1
+#define VALIDATION_PARANOID 2
+
+#ifndef VALIDATION_LEVEL
+#define VALIDATION_LEVEL VALIDATION_BOUNDARIES
+#endif
+
+[[noreturn]] inline void ValidationFailed(const char* message, const char* file, int line) {
+    std::fprintf(stderr, "%s:%d: validation failed: %s\n", file, line, message);
+    std::abort();
+}
+
+#define VALIDATION_CHECK_INNER(cond, message) \
+    ((cond) ? (void)0 : ValidationFailed(message, __FILE__, __LINE__))
+
+#if VALIDATION_LEVEL >= VALIDATION_BOUNDARIES
+#define BOUNDARY_CHECK(cond, message) VALIDATION_CHECK_INNER(cond, message)
+#else
+#define BOUNDARY_CHECK(cond, message) ((void)0)
+#endif
+
+#if VALIDATION_LEVEL >= VALIDATION_PARANOID
+#define PARANOID_CHECK(cond, message) VALIDATION_CHECK_INNER(cond, message)
+#else
+#define PARANOID_CHECK(cond, message) ((void)0)
+#endif
+
+// Whether a coordinate is finite and inside EngineBounds; NaN fails both
+// comparisons, so one test covers both. Branch-free so scans vectorize.
+inline bool CoordinateValid(double v, double max) { return (v < max) & (v > -max); }
+
+// First vertex in `verts` (a Vec3Buffer or any buffer with x()/y()/z()
+// lanes) that is not finite or lies outside EngineBounds, or verts.size()
+// if there is none. One branch-free pass over the lanes; the offending
+// index is only searched for when the pass finds something.
+template <typename Positions>
+inline size_t FindInvalidVertex(const Positions& verts) {
+    const size_t n = verts.size();
+    const auto x = verts.x(), y = verts.y(), z = verts.z();
+    size_t invalid = 0;
+    for (size_t i = 0; i < n; ++i) {
+        invalid += !CoordinateValid(x[i], MAX_X_COORDINATE);
+        invalid += !CoordinateValid(y[i], MAX_Y_COORDINATE);
+        invalid += !CoordinateValid(z[i], MAX_Z_COORDINATE);
+    }
+    if (invalid == 0) return n;
+    for (size_t i = 0; i < n; ++i)
+        if (!CoordinateValid(x[i], MAX_X_COORDINATE) ||
+            !CoordinateValid(y[i], MAX_Y_COORDINATE) ||
+            !CoordinateValid(z[i], MAX_Z_COORDINATE))
+            return i;
+    return n;
+}
+
+// Boundary validation of a whole vertex buffer: reports the first bad
+// vertex of `what` on stderr and returns false. Always true with
+// validation off.
+template <typename Positions>
+inline bool ValidateVertices(const Positions& verts, const char* what) {
+    if constexpr (VALIDATION_LEVEL >= VALIDATION_BOUNDARIES) {
+        const size_t bad = FindInvalidVertex(verts);
+        if (bad != verts.size()) {
+            std::fprintf(stderr, "%s: vertex %zu (%g, %g, %g) is not finite or out of bounds\n",
+                         what, bad, double(verts.x()[bad]), double(verts.y()[bad]),
+                         double(verts.z()[bad]));
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,366 @@
+#pragma once
+#include "CameraSettings.hpp"
+#include "DataTypes.hpp"
+#include "Validation.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/*
+    VectorBatch.hpp
+
+    Description:
+        Whole-buffer / range versions of the VectorOperations math, written
+        against the SoA lanes of Vec3Buffer. Each kernel is written once over
+        a small lane abstraction and compiled for AVX (4 doubles), SSE2
+        (2 doubles) or plain scalar code, whichever the target supports.
+
+        Kernels operate on [begin, end) and write into output buffers that
+        are already sized; the whole-buffer overloads resize the output first.
+        Output may alias an input. Every kernel touch()es the Vec3Buffer it
+        writes, so patching a sub-range also invalidates derived data.
+*/
+
+namespace BatchSimd {
+
+// Scalar lane: the fallback target, and the tail of every vector range
+struct ScalarLane {
+    using V = double;
+    static constexpr size_t width = 1;
+    static inline V load(const double* p) { return *p; }
+    static inline V load(const float* p) { return *p; }
+    static inline V load(const uint16_t* p) { return *p; }
+    static inline void store(double* p, V v) { *p = v; }
+    static inline V set1(double s) { return s; }
+    static inline V add(V a, V b) { return a + b; }
+    static inline V sub(V a, V b) { return a - b; }
+    static inline V mul(V a, V b) { return a * b; }
+    static inline V div(V a, V b) { return a / b; }
+    static inline V sqrt(V a) { return std::sqrt(a); }
+    static inline V positive_mask(V a) { return a > 0.0 ? 1.0 : 0.0; }
+    static inline V select_or_zero(V mask, V a) { return mask != 0.0 ? a : 0.0; }
+};
+
+// Widest lane the target supports
+#if defined(__AVX2__) || defined(__AVX__)
+struct Lane {
+    using V = __m256d;
+    static constexpr size_t width = 4;
+    static inline V load(const double* p) { return _mm256_loadu_pd(p); }
+    static inline V load(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+    static inline V load(const uint16_t* p) {
+        const __m128i q = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+        return _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(q));
+    }
+    static inline void store(double* p, V v) { _mm256_storeu_pd(p, v); }
+    static inline V set1(double s) { return _mm256_set1_pd(s); }
+    static inline V add(V a, V b) { return _mm256_add_pd(a, b); }
+    static inline V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+    static inline V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    static inline V div(V a, V b) { return _mm256_div_pd(a, b); }
+    static inline V sqrt(V a) { return _mm256_sqrt_pd(a); }
+    static inline V positive_mask(V a) { return _mm256_cmp_pd(a, _mm256_setzero_pd(), _CMP_GT_OQ); }
+    // Keep `a` where mask is set, zero elsewhere
+    static inline V select_or_zero(V mask, V a) { return _mm256_and_pd(mask, a); }
+};
+#elif defined(__SSE2__)
+struct Lane {
+    using V = __m128d;
+    static constexpr size_t width = 2;
+    static inline V load(const double* p) { return _mm_loadu_pd(p); }
+    static inline V load(const float* p) {
+        return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+    }
+    static inline V load(const uint16_t* p) { return _mm_set_pd(p[1], p[0]); }
+    static inline void store(double* p, V v) { _mm_storeu_pd(p, v); }
+    static inline V set1(double s) { return _mm_set1_pd(s); }
+    static inline V add(V a, V b) { return _mm_add_pd(a, b); }
+    static inline V sub(V a, V b) { return _mm_sub_pd(a, b); }
+    static inline V mul(V a, V b) { return _mm_mul_pd(a, b); }
+    static inline V div(V a, V b) { return _mm_div_pd(a, b); }
+    static inline V sqrt(V a) { return _mm_sqrt_pd(a); }
+    static inline V positive_mask(V a) { return _mm_cmpgt_pd(a, _mm_setzero_pd()); }
+    static inline V select_or_zero(V mask, V a) { return _mm_and_pd(mask, a); }
+};
+#else
+using Lane = ScalarLane;
+#endif
+
+// Run `body.template operator()<L>(i)` over [begin, end): vector steps first,
+// then the scalar tail
+template <typename Body>
+inline void ForEachLane(size_t begin, size_t end, Body&& body) {
+    size_t i = begin;
+    if constexpr (Lane::width > 1) {
+        for (; i + Lane::width <= end; i += Lane::width)
+            body.template operator()<Lane>(i);
+    }
+    for (; i < end; ++i)
+        body.template operator()<ScalarLane>(i);
+}
+
+} // namespace BatchSimd
+
+// ─────────────────────────────────────────────
+// Range kernels
+// ─────────────────────────────────────────────
+
+inline void VecAddBatch(const Vec3Buffer& lhs, const Vec3Buffer& rhs,
+                        Vec3Buffer& out, size_t begin, size_t end) {
+    BOUNDARY_CHECK(end <= lhs.size() && end <= rhs.size() && end <= out.size(), "BATCH ADD: range out of bounds");
+    BatchSimd::ForEachLane(begin, end, [&]<typename L>(size_t i) {
+        L::store(&out.x()[i], L::add(L::load(&lhs.x()[i]), L::load(&rhs.x()[i])));
+        L::store(&out.y()[i], L::add(L::load(&lhs.y()[i]), L::load(&rhs.y()[i])));
+        L::store(&out.z()[i], L::add(L::load(&lhs.z()[i]), L::load(&rhs.z()[i])));
+    });
+    out.touch();
+}
+
+inline void VecSubBatch(const Vec3Buffer& minuend, const Vec3Buffer& subtrahend,
+                        Vec3Buffer& out, size_t begin, size_t end) {
+    BOUNDARY_CHECK(end <= minuend.size() && end <= subtrahend.size() && end <= out.size(), "BATCH SUB: range out of bounds");
+    BatchSimd::ForEachLane(begin, end, [&]<typename L>(size_t i) {
+        L::store(&out.x()[i], L::sub(L::load(&minuend.x()[i]), L::load(&subtrahend.x()[i])));
+        L::store(&out.y()[i], L::sub(L::load(&minuend.y()[i]), L::load(&subtrahend.y()[i])));
+        L::store(&out.z()[i], L::sub(L::load(&minuend.z()[i]), L::load(&subtrahend.z()[i])));
+    });
+    out.touch();
+}
+
+inline void VecScaleBatch(const Vec3Buffer& base, double scalar,
+                          Vec3Buffer& out, size_t begin, size_t end) {
+    BOUNDARY_CHECK(std::isfinite(scalar), "BATCH SCALE: scalar must be finite");
+    BOUNDARY_CHECK(end <= base.size() && end <= out.size(), "BATCH SCALE: range out of bounds");
+    BatchSimd::ForEachLane(begin, end, [&]<typename L>(size_t i) {
+        const auto s = L::set1(scalar);
+        L::store(&out.x()[i], L::mul(L::load(&base.x()[i]), s));
+        L::store(&out.y()[i], L::mul(L::load(&base.y()[i]), s));
+        L::store(&out.z()[i], L::mul(L::load(&base.z()[i]), s));
+    });
+    out.touch();
+}
+
+inline void VecDotBatch(const Vec3Buffer& lhs, const Vec3Buffer& rhs,
+                        std::vector<double>& out, size_t begin, size_t end) {
+    BOUNDARY_CHECK(end <= lhs.size() && end <= rhs.size() && end <= out.size(), "BATCH DOT: range out of bounds");
+    BatchSimd::ForEachLane(begin, end, [&]<typename L>(size_t i) {
+        auto d = L::mul(L::load(&lhs.x()[i]), L::load(&rhs.x()[i]));
+        d = L::add(d, L::mul(L::load(&lhs.y()[i]), L::load(&rhs.y()[i])));
+        d = L::add(d, L::mul(L::load(&lhs.z()[i]), L::load(&rhs.z()[i])));
+        L::store(&out[i], d);
+    });
+}
+
+inline void VecCrossBatch(const Vec3Buffer& base, const Vec3Buffer& operand,
+                          Vec3Buffer& out, size_t begin, size_t end) {
+    BOUNDARY_CHECK(end <= base.size() && end <= operand.size() && end <= out.size(), "BATCH CROSS: range out of bounds");
+    BatchSimd::ForEachLane(begin, end, [&]<typename L>(size_t i) {
+        const auto ax = L::load(&base.x()[i]), ay = L::load(&base.y()[i]), az = L::load(&base.z()[i]);
+        const auto bx = L::load(&operand.x()[i]), by = L::load(&operand.y()[i]), bz = L::load(&operand.z()[i]);
+        L::store(&out.x()[i], L::sub(L::mul(ay, bz), L::mul(az, by)));
+        L::store(&out.y()[i], L::sub(L::mul(az, bx), L::mul(ax, bz)));
+        L::store(&out.z()[i], L::sub(L::mul(ax, by), L::mul(ay, bx)));
+    });
+    out.touch();
+}
+
+// Zero-length vectors normalize to zero, as in VecNormalizeAtomic
+inline void VecNormalizeBatch(const Vec3Buffer& base,
+                              Vec3Buffer& out, size_t begin, size_t end) {
+    BOUNDARY_CHECK(end <= base.size() && end <= out.size(), "BATCH NORMALIZE: range out of bounds");
+    BatchSimd::ForEachLane(begin, end, [&]<typename L>(size_t i) {
+        const auto x = L::load(&base.x()[i]), y = L::load(&base.y()[i]), z = L::load(&base.z()[i]);
+        const auto len = L::sqrt(L::add(L::add(L::mul(x, x), L::mul(y, y)), L::mul(z, z)));
+        const auto inv = L::select_or_zero(L::positive_mask(len), L::div(L::set1(1.0), len));
+        L::store(&out.x()[i], L::mul(x, inv));
+        L::store(&out.y()[i], L::mul(y, inv));
+        L::store(&out.z()[i], L::mul(z, inv));
+    });
+    out.touch();
+}
+
+inline void VecLerpBatch(const Vec3Buffer& start, const Vec3Buffer& finish,
+                         double t, Vec3Buffer& out, size_t begin, size_t end) {
+    BOUNDARY_CHECK(end <= start.size() && end <= finish.size() && end <= out.size(), "BATCH LERP: range out of bounds");
+    BatchSimd::ForEachLane(begin, end, [&]<typename L>(size_t i) {
+        const auto tv = L::set1(t);
+        const auto sx = L::load(&start.x()[i]), sy = L::load(&start.y()[i]), sz = L::load(&start.z()[i]);
+        L::store(&out.x()[i], L::add(sx, L::mul(L::sub(L::load(&finish.x()[i]), sx), tv)));
+        L::store(&out.y()[i], L::add(sy, L::mul(L::sub(L::load(&finish.y()[i]), sy), tv)));
+        L::store(&out.z()[i], L::add(sz, L::mul(L::sub(L::load(&finish.z()[i]), sz), tv)));
+    });
+    out.touch();
+}
+
+namespace BatchSimd {
+
+// Rotate eye-relative positions into camera space and project them; the
+// shared tail of the transform kernels. Writes element `j` of cam/proj.
+template <typename L>
+inline void StoreCameraProjected(typename L::V rx, typename L::V ry, typename L::V rz,
+                                 const CameraView_t& view, double fx, double focal_length,
+                                 Vec3Buffer& cam, Vec2Buffer& proj, size_t j) {
+    auto row = [&](const Vec3_t& axis) {
+        return L::add(L::add(L::mul(rx, L::set1(axis.x)), L::mul(ry, L::set1(axis.y))),
+                      L::mul(rz, L::set1(axis.z)));
+    };
+    const auto cx = row(view.right);
+    const auto cy = row(view.up);
+    const auto cz = row(view.forward);
+    L::store(&cam.x()[j], cx);
+    L::store(&cam.y()[j], cy);
+    L::store(&cam.z()[j], cz);
+
+    const auto inv_z = L::select_or_zero(L::positive_mask(cz), L::div(L::set1(1.0), cz));
+    L::store(&proj.x()[j], L::mul(L::mul(cx, inv_z), L::set1(fx)));
+    L::store(&proj.y()[j], L::mul(L::mul(cy, inv_z), L::set1(focal_length)));
+}
+
+template <typename Positions>
+inline constexpr bool IS_QUANTIZED = requires(const Positions& p) { p.scale; p.offset; };
+
+} // namespace BatchSimd
+
+// Fused WorldToCamera + ProjectToScreen. Vertices at or behind the eye
+// (cam.z <= 0) project to (0, 0); callers must check cam.z before use.
+//
+// `world` is any SoA position buffer with x()/y()/z() lanes (double, float
+// or uint16_t). Quantized buffers also carry `offset` and `scale`; they are
+// dequantized here (world = offset + q * scale), folded into the eye offset.
+template <typename Positions>
+inline void TransformToScreenBatch(const Positions& world,
+                                   const CameraView_t& view,
+                                   const Vec3_t& eye,
+                                   double focal_length,
+                                   double aspect_ratio,
+                                   Vec3Buffer& cam,
+                                   Vec2Buffer& proj,
+                                   size_t begin, size_t end) {
+    BOUNDARY_CHECK(end <= world.size() && end <= cam.size() && end <= proj.size(), "BATCH TRANSFORM: range out of bounds");
+    constexpr bool quantized = BatchSimd::IS_QUANTIZED<Positions>;
+    Vec3_t bias = {-eye.x, -eye.y, -eye.z};
+    Vec3_t scale = {1.0, 1.0, 1.0};
+    if constexpr (quantized) {
+        bias = {world.offset.x - eye.x, world.offset.y - eye.y, world.offset.z - eye.z};
+        scale = world.scale;
+    }
+    const double fx = (focal_length / aspect_ratio) * CameraSettings::pixel_aspect;
+    BatchSimd::ForEachLane(begin, end, [&]<typename L>(size_t i) {
+        auto relative = [&](const auto* lane, double s, double b) {
+            if constexpr (quantized)
+                return L::add(L::mul(L::load(lane), L::set1(s)), L::set1(b));
+            else
+                return L::add(L::load(lane), L::set1(b));
+        };
+        const auto rx = relative(&world.x()[i], scale.x, bias.x);
+        const auto ry = relative(&world.y()[i], scale.y, bias.y);
+        const auto rz = relative(&world.z()[i], scale.z, bias.z);
+        BatchSimd::StoreCameraProjected<L>(rx, ry, rz, view, fx, focal_length, cam, proj, i);
+    });
+    cam.touch();
+}
+
+// Same as above for one instance of a shared mesh: `local` goes through
+// `model` to world space first. Source vertices [begin, end) are written to
+// cam/proj starting at `dst`, so several instances can share one cache.
+// Quantization and the eye offset are folded into the model transform.
+template <typename Positions>
+inline void TransformInstanceToScreenBatch(const Positions& local,
+                                           const ModelTransform_t& model,
+                                           const CameraView_t& view,
+                                           const Vec3_t& eye,
+                                           double focal_length,
+                                           double aspect_ratio,
+                                           Vec3Buffer& cam,
+                                           Vec2Buffer& proj,
+                                           size_t begin, size_t end, size_t dst) {
+    BOUNDARY_CHECK(end <= local.size() && dst + (end - begin) <= cam.size() &&
+                   dst + (end - begin) <= proj.size(),
+                   "BATCH INSTANCE TRANSFORM: range out of bounds");
+    ModelTransform_t m = model;
+    if constexpr (BatchSimd::IS_QUANTIZED<Positions>) {
+        auto scaled = [](const Vec3_t& v, double s) { return Vec3_t{v.x * s, v.y * s, v.z * s}; };
+        m.x_axis = scaled(model.x_axis, local.scale.x);
+        m.y_axis = scaled(model.y_axis, local.scale.y);
+        m.z_axis = scaled(model.z_axis, local.scale.z);
+        const Vec3_t o = local.offset;
+        m.position = {model.position.x + model.x_axis.x * o.x + model.y_axis.x * o.y + model.z_axis.x * o.z,
+                      model.position.y + model.x_axis.y * o.x + model.y_axis.y * o.y + model.z_axis.y * o.z,
+                      model.position.z + model.x_axis.z * o.x + model.y_axis.z * o.y + model.z_axis.z * o.z};
+    }
+    const Vec3_t bias = {m.position.x - eye.x, m.position.y - eye.y, m.position.z - eye.z};
+    const double fx = (focal_length / aspect_ratio) * CameraSettings::pixel_aspect;
+    BatchSimd::ForEachLane(begin, end, [&]<typename L>(size_t i) {
+        const auto px = L::load(&local.x()[i]);
+        const auto py = L::load(&local.y()[i]);
+        const auto pz = L::load(&local.z()[i]);
+        auto world = [&](double ax, double ay, double az, double b) {
+            return L::add(L::add(L::add(L::mul(px, L::set1(ax)), L::mul(py, L::set1(ay))),
+                                 L::mul(pz, L::set1(az))),
+                          L::set1(b));
+        };
+        const auto rx = world(m.x_axis.x, m.y_axis.x, m.z_axis.x, bias.x);
+        const auto ry = world(m.x_axis.y, m.y_axis.y, m.z_axis.y, bias.y);
+        const auto rz = world(m.x_axis.z, m.y_axis.z, m.z_axis.z, bias.z);
+        BatchSimd::StoreCameraProjected<L>(rx, ry, rz, view, fx, focal_length, cam, proj, dst + (i - begin));
+    });
+    cam.touch();
+}
+
+// ─────────────────────────────────────────────
+// Whole-buffer overloads
+// ─────────────────────────────────────────────
+
+inline void VecAddBatch(const Vec3Buffer& lhs, const Vec3Buffer& rhs, Vec3Buffer& out) {
+    out.resize(lhs.size());
+    VecAddBatch(lhs, rhs, out, 0, lhs.size());
+}
+
+inline void VecSubBatch(const Vec3Buffer& minuend, const Vec3Buffer& subtrahend, Vec3Buffer& out) {
+    out.resize(minuend.size());
+    VecSubBatch(minuend, subtrahend, out, 0, minuend.size());
+}
+
+inline void VecScaleBatch(const Vec3Buffer& base, double scalar, Vec3Buffer& out) {
+    out.resize(base.size());
+    VecScaleBatch(base, scalar, out, 0, base.size());
+}
+
+inline void VecDotBatch(const Vec3Buffer& lhs, const Vec3Buffer& rhs, std::vector<double>& out) {
+    out.resize(lhs.size());
+    VecDotBatch(lhs, rhs, out, 0, lhs.size());
+}
+
+inline void VecCrossBatch(const Vec3Buffer& base, const Vec3Buffer& operand, Vec3Buffer& out) {
+    out.resize(base.size());
+    VecCrossBatch(base, operand, out, 0, base.size());
+}
+
+inline void VecNormalizeBatch(const Vec3Buffer& base, Vec3Buffer& out) {
+    out.resize(base.size());
+    VecNormalizeBatch(base, out, 0, base.size());
+}
+
+inline void VecLerpBatch(const Vec3Buffer& start, const Vec3Buffer& finish, double t, Vec3Buffer& out) {
+    out.resize(start.size());
+    VecLerpBatch(start, finish, t, out, 0, start.size());
+}
+
+template <typename Positions>
+inline void TransformToScreenBatch(const Positions& world,
+                                   const CameraView_t& view,
+                                   const Vec3_t& eye,
+                                   double focal_length,
+                                   double aspect_ratio,
+                                   Vec3Buffer& cam,
+                                   Vec2Buffer& proj) {
+    cam.resize(world.size());
+    proj.resize(world.size());
+    TransformToScreenBatch(world, view, eye, focal_length, aspect_ratio, cam, proj, 0, world.size());
+}
@@ -2,11 +2,23 @@
 #include "DataTypes.hpp"
 #include "CameraMath.hpp"
 #include "CameraSettings.hpp"
+#include "Clipping.hpp"
+#include "TransformStage.hpp"
+#include "MeshTopology.hpp"
+#include "Surface.hpp"
+#include <cmath>
+#include <memory_resource>
+#include <span>
 #include <unordered_set>
 
-// Extract unique edges from triangle mesh
-inline std::unordered_set<Edge> ExtractEdges(const TriangleBuffer& tris) {
-    std::unordered_set<Edge> edges;
+// Extract unique edges from triangle mesh (one-off; per-frame passes use the
+// cached MeshTopology edge array instead). The set's nodes come from `memory`,
+// e.g. a FrameArena.
+template <typename Index>
+inline std::pmr::unordered_set<Edge> ExtractEdges(
+    const TriangleList<Index>& tris,
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource()) {
+    std::pmr::unordered_set<Edge> edges(memory);
     for (const auto& tri : tris.indices) {
         edges.insert(Edge(tri[0], tri[1]));
         edges.insert(Edge(tri[1], tri[2]));
@@ -15,17 +27,30 @@ inline std::unordered_set<Edge> ExtractEdges(const TriangleBuffer& tris) {
     return edges;
 }
 
-// Bresenham-style line draw
+// Bresenham-style line draw. Endpoints off the surface are first clipped to
+// it (Cohen-Sutherland), so only visible pixels are stepped. Only pixels
+// inside `scissor` are written; the line steps through the same pixels
+// whatever the scissor, so a partial redraw matches a full one.
 inline void DrawLine(Int2_t a, Int2_t b,
-    char (&fb)[CameraSettings::screen_height][CameraSettings::screen_width],
+    Frame& fb,
+    const PixelRect_t& scissor,
     char ch = '*') {
+    if (fb.empty() || scissor.empty()) return;
+    if (!scissor.Overlaps({std::min(a.x, b.x), std::min(a.y, b.y),
+                           std::max(a.x, b.x), std::max(a.y, b.y)})) return;
+    const ClipRect_t bounds = {0.0, 0.0, fb.width() - 1.0, fb.height() - 1.0};
+    if (Outcode(a.x, a.y, bounds) | Outcode(b.x, b.y, bounds)) {
+        Vec2_t pa = {double(a.x), double(a.y)}, pb = {double(b.x), double(b.y)};
+        if (!ClipLine(pa, pb, bounds)) return;
+        a = {static_cast<int>(std::lround(pa.x)), static_cast<int>(std::lround(pa.y))};
+        b = {static_cast<int>(std::lround(pb.x)), static_cast<int>(std::lround(pb.y))};
+    }
     int x0 = a.x, y0 = a.y, x1 = b.x, y1 = b.y;
     int dx = std::abs(x1 - x0), dy = -std::abs(y1 - y0);
     int sx = (x0 < x1) ? 1 : -1, sy = (y0 < y1) ? 1 : -1;
     int err = dx + dy;
     while (true) {
-        if (x0 >= 0 && x0 < CameraSettings::screen_width &&
-            y0 >= 0 && y0 < CameraSettings::screen_height)
+        if (x0 >= scissor.x0 && x0 <= scissor.x1 && y0 >= scissor.y0 && y0 <= scissor.y1)
             fb[y0][x0] = ch;
         if (x0 == x1 && y0 == y1) break;
         int e2 = 2 * err;
@@ -34,27 +59,77 @@ inline void DrawLine(Int2_t a, Int2_t b,
     }
 }
 
-// Full render from mesh + camera
-inline void RenderMeshOutline(const Vec3Buffer& verts,
-                              const TriangleBuffer& tris,
-                              const Vec3_t& eye,
-                              const Vec3_t& target,
-                              char (&fb)[CameraSettings::screen_height][CameraSettings::screen_width]) {
-    auto edges = ExtractEdges(tris);
-    auto view = LookAt(eye, target, CAMERA_UP);
-    const double focal = CameraSettings::FovToFocalLength(CameraSettings::camera_fov);
+inline void DrawLine(Int2_t a, Int2_t b,
+    Frame& fb,
+    char ch = '*') {
+    DrawLine(a, b, fb, fb.bounds(), ch);
+}
 
+// Draw every edge from the shared post-transform cache, read by vertex
+// index. Edges crossing the near plane are clipped in camera space and the
+// rest of the clipping happens in subpixel screen space, before rounding.
+// Only pixels inside `scissor` are written.
+inline void RenderEdges(const TransformedVertices& xf,
+                        std::span<const Edge> edges,
+                        Frame& fb,
+                        const PixelRect_t& scissor,
+                        char ch = '*') {
+    if (fb.empty() || scissor.empty()) return;
+    const double near = CameraSettings::near_plane;
+    const ClipRect_t bounds = {0.0, 0.0, fb.width() - 1.0, fb.height() - 1.0};
     for (const auto& e : edges) {
-        Vec3Buffer cam;
-        WorldToCamera(verts, e.a, view, eye, cam);
-        WorldToCamera(verts, e.b, view, eye, cam);
-        if (cam.z[0] <= 0 || cam.z[1] <= 0) continue;
-
-        Vec2Buffer proj;
-        ProjectToScreen(cam, 0, focal, CameraSettings::aspect_ratio, proj);
-        ProjectToScreen(cam, 1, focal, CameraSettings::aspect_ratio, proj);
-        Int2_t p0 = MapToScreen(proj, 0, CameraSettings::screen_width, CameraSettings::screen_height);
-        Int2_t p1 = MapToScreen(proj, 1, CameraSettings::screen_width, CameraSettings::screen_height);
-        DrawLine(p0, p1, fb);
+        const double za = xf.cam.z()[e.a], zb = xf.cam.z()[e.b];
+        if (za < near && zb < near) continue;
+
+        Vec2_t p0, p1;
+        if (za >= near && zb >= near) {
+            p0 = MapToScreenSubpixel(xf.proj, e.a, fb.width(), fb.height());
+            p1 = MapToScreenSubpixel(xf.proj, e.b, fb.width(), fb.height());
+        } else {
+            Vec3_t a = {xf.cam.x()[e.a], xf.cam.y()[e.a], za};
+            Vec3_t b = {xf.cam.x()[e.b], xf.cam.y()[e.b], zb};
+            Vec3_t& behind = za < near ? a : b;
+            const double t = (near - a.z) / (b.z - a.z);
+            behind = {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, near};
+            p0 = xf.ProjectSubpixel(a, fb.width(), fb.height());
+            p1 = xf.ProjectSubpixel(b, fb.width(), fb.height());
+        }
+        if (!ClipLine(p0, p1, bounds)) continue;
+
+        DrawLine({static_cast<int>(std::round(p0.x)), static_cast<int>(std::round(p0.y))},
+                 {static_cast<int>(std::round(p1.x)), static_cast<int>(std::round(p1.y))},
+                 fb, scissor, ch);
     }
 }
+
+inline void RenderEdges(const TransformedVertices& xf,
+                        std::span<const Edge> edges,
+                        Frame& fb,
+                        char ch = '*') {
+    RenderEdges(xf, edges, fb, fb.bounds(), ch);
+}
+
+// Full render from mesh + camera; `topo` is rebuilt only when `tris` changes
+template <typename Positions, typename Index>
+inline void RenderMeshOutline(const Positions& verts,
+                              const TriangleList<Index>& tris,
+                              const Vec3_t& eye,
+                              const Vec3_t& target,
+                              TransformedVertices& xf,
+                              MeshTopology& topo,
+                              Frame& fb) {
+    topo.Update(tris);
+    TransformVertices(verts, eye, target, xf, fb.aspect_ratio());
+    RenderEdges(xf, topo.edges, fb);
+}
+
+template <typename Positions, typename Index>
+inline void RenderMeshOutline(const Positions& verts,
+                              const TriangleList<Index>& tris,
+                              const Vec3_t& eye,
+                              const Vec3_t& target,
+                              Frame& fb) {
+    TransformedVertices xf;
+    MeshTopology topo;
+    RenderMeshOutline(verts, tris, eye, target, xf, topo, fb);
+}
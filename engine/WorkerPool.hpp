@@ -0,0 +1,106 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ─────────────────────────────────────────────
+// Persistent worker pool
+// ─────────────────────────────────────────────
+//
+// Threads are created once and sleep between jobs. A job is a range of item
+// indices; workers (and the calling thread) claim items with one atomic
+// increment each, so nothing is locked while items are being processed. The
+// mutex is only taken to start a job and to report completion.
+
+class WorkerPool {
+public:
+    // `thread_count` includes the calling thread
+    explicit WorkerPool(unsigned thread_count = std::thread::hardware_concurrency()) {
+        if (thread_count == 0) thread_count = 1;
+        for (unsigned i = 1; i < thread_count; ++i)
+            workers_.emplace_back([this] { WorkerLoop(); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    inline unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+    // Run fn(i) for every i in [0, count) and return once all items are done
+    template <typename Fn>
+    void ParallelFor(size_t count, Fn&& fn) {
+        using F = std::remove_reference_t<Fn>;
+        if (count == 0) return;
+        if (workers_.empty() || count == 1) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+
+        job_ = [](void* ctx, size_t i) { (*static_cast<F*>(ctx))(i); };
+        ctx_ = const_cast<void*>(static_cast<const void*>(&fn));
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_ = workers_.size();
+            ++generation_;
+        }
+        start_cv_.notify_all();
+
+        RunItems();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+private:
+    inline void RunItems() {
+        size_t i;
+        while ((i = next_.fetch_add(1, std::memory_order_relaxed)) < count_)
+            job_(ctx_, i);
+    }
+
+    void WorkerLoop() {
+        uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+            }
+            RunItems();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--pending_ == 0) done_cv_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_ = 0;
+    size_t pending_ = 0;
+    bool stop_ = false;
+
+    void (*job_)(void*, size_t) = nullptr;
+    void* ctx_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_{0};
+};